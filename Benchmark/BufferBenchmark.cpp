@@ -0,0 +1,49 @@
+// File: BufferBenchmark.cpp
+// Author: Rendong Liang (Liong)
+#include "../Include/Testing/Benchmark.hpp"
+#include "../Include/Buffer.hpp"
+
+using namespace LiongPlus;
+using namespace LiongPlus::Testing;
+
+_L_Benchmark_Case(BufferAllocate4K)
+{
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		Buffer buffer(4096, BufferInitialization::Uninitialized);
+		DoNotOptimize(buffer.Field());
+	}
+}
+
+_L_Benchmark_Case(BufferAllocateZeroed4K)
+{
+	state.SetBytesProcessed(4096);
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		Buffer buffer(4096);
+		DoNotOptimize(buffer.Field());
+	}
+}
+
+_L_Benchmark_Case(BufferClone64K)
+{
+	Buffer source(64 * 1024);
+	state.SetBytesProcessed(source.Length());
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		auto copy = source.Clone();
+		DoNotOptimize(copy.Field());
+	}
+}
+
+_L_Benchmark_Case(BufferGrowTo1M)
+{
+	// Growing one chunk at a time, as a stream being read into the buffer would.
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		Buffer buffer;
+		for (size_t length = 4096; length <= 1024 * 1024; length += 4096)
+			buffer.Resize(length);
+		DoNotOptimize(buffer.Field());
+	}
+}
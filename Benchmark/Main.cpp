@@ -0,0 +1,10 @@
+// File: Main.cpp
+// Author: Rendong Liang (Liong)
+#include "../Include/Testing/Benchmark.hpp"
+
+using namespace LiongPlus::Testing;
+
+int main(int argc, char** argv)
+{
+	return Benchmark::Run(argc, argv);
+}
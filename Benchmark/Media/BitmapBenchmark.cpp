@@ -0,0 +1,43 @@
+// File: BitmapBenchmark.cpp
+// Author: Rendong Liang (Liong)
+#include "../../Include/Testing/Benchmark.hpp"
+#include "../../Include/Media/Bitmap.hpp"
+
+using namespace LiongPlus;
+using namespace LiongPlus::Media;
+using namespace LiongPlus::Testing;
+
+static const Size FRAME_SIZE = { 512, 512 };
+
+_L_Benchmark_Case(BitmapInterpretRgbToRgba)
+{
+	Bitmap bitmap(Buffer(FRAME_SIZE.Width * FRAME_SIZE.Height * 3), FRAME_SIZE, PixelType::Rgb);
+	state.SetBytesProcessed(FRAME_SIZE.Width * FRAME_SIZE.Height * 3);
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		auto rgba = bitmap.Interpret(PixelType::Rgba);
+		DoNotOptimize(rgba.Field());
+	}
+}
+
+_L_Benchmark_Case(BitmapInterpretRgbToBgr)
+{
+	Bitmap bitmap(Buffer(FRAME_SIZE.Width * FRAME_SIZE.Height * 3), FRAME_SIZE, PixelType::Rgb);
+	state.SetBytesProcessed(FRAME_SIZE.Width * FRAME_SIZE.Height * 3);
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		auto bgr = bitmap.Interpret(PixelType::Bgr);
+		DoNotOptimize(bgr.Field());
+	}
+}
+
+_L_Benchmark_Case(BitmapGetChunk)
+{
+	Bitmap bitmap(Buffer(FRAME_SIZE.Width * FRAME_SIZE.Height * 4), FRAME_SIZE, PixelType::Rgba);
+	state.SetBytesProcessed(64 * 64 * 4);
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		auto chunk = bitmap.GetChunk({ 128, 128 }, { 64, 64 });
+		DoNotOptimize(chunk.Field());
+	}
+}
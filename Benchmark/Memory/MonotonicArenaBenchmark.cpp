@@ -0,0 +1,56 @@
+// File: MonotonicArenaBenchmark.cpp
+// Author: Rendong Liang (Liong)
+#include "../../Include/Testing/Benchmark.hpp"
+#include "../../Include/Memory/MonotonicArena.hpp"
+
+using namespace LiongPlus;
+using namespace LiongPlus::Memory;
+using namespace LiongPlus::Testing;
+
+static const AllocationSite SITE = { "MonotonicArenaBenchmark", __FILE__, __LINE__ };
+// Allocations made to serve one request: the receive buffer, the body, header strings and nodes, the request and status lines and the serialized response.
+static const size_t REQUEST_ALLOCATIONS[] = { 4096, 1024, 48, 48, 32, 32, 64, 64, 24, 24, 40, 1200 };
+static const size_t REQUEST_ALLOCATION_COUNT = sizeof(REQUEST_ALLOCATIONS) / sizeof(REQUEST_ALLOCATIONS[0]);
+
+// Only the allocator is timed: the difference between the two cases is the allocator time an arena eliminates per request.
+_L_Benchmark_Case(AllocatorPerRequestNewDelete)
+{
+	auto resource = MemoryResource::NewDelete();
+	void* ptrs[REQUEST_ALLOCATION_COUNT];
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		for (size_t j = 0; j < REQUEST_ALLOCATION_COUNT; ++j)
+			ptrs[j] = resource->Allocate(REQUEST_ALLOCATIONS[j], alignof(std::max_align_t), SITE);
+		DoNotOptimize(ptrs);
+		for (size_t j = 0; j < REQUEST_ALLOCATION_COUNT; ++j)
+			resource->Deallocate(ptrs[j], REQUEST_ALLOCATIONS[j], alignof(std::max_align_t), SITE);
+	}
+}
+
+_L_Benchmark_Case(AllocatorPerRequestArena)
+{
+	MonotonicArena arena;
+	void* ptrs[REQUEST_ALLOCATION_COUNT];
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		for (size_t j = 0; j < REQUEST_ALLOCATION_COUNT; ++j)
+			ptrs[j] = arena.Allocate(REQUEST_ALLOCATIONS[j], alignof(std::max_align_t), SITE);
+		DoNotOptimize(ptrs);
+		arena.Reset();
+	}
+}
+
+_L_Benchmark_Case(AllocatorPerRequestArenaScope)
+{
+	// As a handler would use it: installed as the thread default, so containers allocate from it without being told.
+	MonotonicArena arena;
+	void* ptrs[REQUEST_ALLOCATION_COUNT];
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		MonotonicArena::Scope scope(arena);
+		auto resource = MemoryResource::Default();
+		for (size_t j = 0; j < REQUEST_ALLOCATION_COUNT; ++j)
+			ptrs[j] = resource->Allocate(REQUEST_ALLOCATIONS[j], alignof(std::max_align_t), SITE);
+		DoNotOptimize(ptrs);
+	}
+}
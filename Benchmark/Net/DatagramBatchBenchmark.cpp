@@ -0,0 +1,67 @@
+// File: DatagramBatchBenchmark.cpp
+// Author: Rendong Liang (Liong)
+#include "../../Include/Testing/Benchmark.hpp"
+#include "../../Include/Net/Socket.hpp"
+#include "../../Include/Net/DatagramBatch.hpp"
+
+#ifdef _L_LINUX
+using namespace LiongPlus;
+using namespace LiongPlus::Net;
+using namespace LiongPlus::Testing;
+
+static const size_t BATCH_SIZE = 32;
+static const size_t DATAGRAM_LENGTH = 64;
+
+// A UDP socket bound to a free loopback port, and the address it got.
+static Socket BindLoopback(IPv4EndPoint& addr)
+{
+	Socket socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	socket.Bind(addr);
+	socklen_t length = sizeof(sockaddr_in);
+	if (getsockname(socket.Handle(), (sockaddr*)addr.Field(), &length) < 0)
+		throw std::runtime_error("Failed in finding a free port.");
+	return socket;
+}
+
+// Each iteration is one datagram sent and received over loopback, so the rate is packets per second. At most a batch is in flight, which fits the default receive buffer.
+_L_Benchmark_Case(DatagramBatchLoopback)
+{
+	IPv4EndPoint receiverAddr("127.0.0.1", 0), senderAddr("127.0.0.1", 0);
+	auto receiver = BindLoopback(receiverAddr);
+	auto sender = BindLoopback(senderAddr);
+	DatagramBatch outgoing(BATCH_SIZE, DATAGRAM_LENGTH), incoming(BATCH_SIZE, DATAGRAM_LENGTH);
+	for (size_t i = 0; i < BATCH_SIZE; ++i)
+		outgoing.SetAddress(i, receiverAddr);
+	state.SetBytesProcessed(DATAGRAM_LENGTH);
+	for (size_t i = 0; i < state.Iterations();)
+	{
+		auto count = std::min(BATCH_SIZE, state.Iterations() - i);
+		size_t sent = sender.SendBatch(outgoing, count, 0);
+		for (size_t received = 0; received < sent;)
+			received += receiver.ReceiveBatch(incoming, 0);
+		DoNotOptimize(incoming.Data(0).Field());
+		i += sent;
+	}
+}
+
+// The same traffic with a system call per datagram each way, for comparison.
+_L_Benchmark_Case(DatagramSingleLoopback)
+{
+	IPv4EndPoint receiverAddr("127.0.0.1", 0), senderAddr("127.0.0.1", 0);
+	auto receiver = BindLoopback(receiverAddr);
+	auto sender = BindLoopback(senderAddr);
+	Buffer outgoing(DATAGRAM_LENGTH), incoming(DATAGRAM_LENGTH);
+	SocketAddress peer(SocketAddress::MAX_LENGTH);
+	state.SetBytesProcessed(DATAGRAM_LENGTH);
+	for (size_t i = 0; i < state.Iterations();)
+	{
+		auto count = std::min(BATCH_SIZE, state.Iterations() - i);
+		for (size_t j = 0; j < count; ++j)
+			sender.SendTo(outgoing, receiverAddr);
+		for (size_t j = 0; j < count; ++j)
+			receiver.ReceiveFrom(incoming, peer);
+		DoNotOptimize(incoming.Field());
+		i += count;
+	}
+}
+#endif // _L_LINUX
@@ -0,0 +1,53 @@
+// File: HttpHandlingBenchmark.cpp
+// Author: Rendong Liang (Liong)
+#include "../../Include/Testing/Benchmark.hpp"
+#include "../../Include/Memory/MonotonicArena.hpp"
+#include "../../Include/Net/HttpMessage.hpp"
+
+using namespace LiongPlus;
+using namespace LiongPlus::Memory;
+using namespace LiongPlus::Net;
+using namespace LiongPlus::Testing;
+
+static const char REQUEST[] = "GET /api/items?page=2 HTTP/1.1\r\nHost: localhost\r\nAccept: */*\r\n\r\n";
+
+// What a handler does for one request: receive it, read the request line, build the body and the response and serialize it.
+static void HandleRequest()
+{
+	Buffer received(4096, BufferInitialization::Uninitialized);
+	memcpy(received.Field(), REQUEST, sizeof(REQUEST) - 1);
+	std::string_view text(received.Field(), sizeof(REQUEST) - 1);
+	auto methodEnd = text.find(' ');
+	auto pathEnd = text.find(' ', methodEnd + 1);
+	HttpRequestLine requestLine(1, 1, std::string(text.substr(0, methodEnd)), std::string(text.substr(methodEnd + 1, pathEnd - methodEnd - 1)));
+
+	Buffer body(1024, BufferInitialization::Uninitialized);
+	auto length = snprintf(body.Field(), body.Length(), "{\"path\":\"%s\",\"items\":[1,2,3,5,8,13]}", requestLine.Path.c_str());
+	body.Resize(length);
+
+	HttpHeader header;
+	std::string contentType = HttpHeader::Entity::ContentType, contentLength = HttpHeader::Entity::ContentLength;
+	header[contentType] = "application/json";
+	header[contentLength] = std::to_string(length);
+	HttpStatusLine statusLine(1, 1, 200, "OK");
+	HttpResponse response(header, statusLine, body);
+	auto sent = response.ToBuffer();
+	DoNotOptimize(sent.Field());
+}
+
+_L_Benchmark_Case(HttpHandleRequest)
+{
+	for (size_t i = 0; i < state.Iterations(); ++i)
+		HandleRequest();
+}
+
+_L_Benchmark_Case(HttpHandleRequestInArena)
+{
+	// Buffers come from the arena, which is reset after each request; strings still go to the heap.
+	MonotonicArena arena;
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		MonotonicArena::Scope scope(arena);
+		HandleRequest();
+	}
+}
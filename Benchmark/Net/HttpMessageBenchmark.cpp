@@ -0,0 +1,65 @@
+// File: HttpMessageBenchmark.cpp
+// Author: Rendong Liang (Liong)
+#include "../../Include/Testing/Benchmark.hpp"
+#include "../../Include/Net/HttpMessage.hpp"
+
+using namespace LiongPlus;
+using namespace LiongPlus::Net;
+using namespace LiongPlus::Testing;
+
+static HttpHeader MakeHeader(size_t contentLength)
+{
+	std::pair<std::string, std::string> fields[] =
+	{
+		{ HttpHeader::Entity::ContentType, "application/json" },
+		{ HttpHeader::Entity::ContentLength, std::to_string(contentLength) },
+		{ HttpHeader::General::CacheControl, "no-cache" },
+		{ HttpHeader::General::Connection, "keep-alive" },
+		{ HttpHeader::Response::Server, "LiongPlus" },
+	};
+	HttpHeader header;
+	for (auto& field : fields)
+		header[field.first] = field.second;
+	return header;
+}
+
+_L_Benchmark_Case(HttpResponseToBuffer)
+{
+	SharedBuffer content(Buffer(1024));
+	auto header = MakeHeader(content.Length());
+	HttpStatusLine line(1, 1, 200, "OK");
+	HttpResponse response(header, line, content);
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		auto buffer = response.ToBuffer();
+		DoNotOptimize(buffer.Field());
+	}
+}
+
+_L_Benchmark_Case(HttpResponseBuildAndSerialize)
+{
+	SharedBuffer content(Buffer(1024));
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		auto header = MakeHeader(content.Length());
+		HttpStatusLine line(1, 1, 200, "OK");
+		HttpResponse response(header, line, content);
+		auto buffer = response.ToBuffer();
+		DoNotOptimize(buffer.Field());
+	}
+}
+
+_L_Benchmark_Case(HttpRequestToBuffer)
+{
+	HttpHeader header;
+	std::string host = HttpHeader::Request::Host, accept = HttpHeader::Request::Accept;
+	header[host] = "localhost";
+	header[accept] = "*/*";
+	HttpRequestLine line(1, 1, "GET", "/api/items?page=2");
+	HttpRequest request(header, line, SharedBuffer());
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		auto buffer = request.ToBuffer();
+		DoNotOptimize(buffer.Field());
+	}
+}
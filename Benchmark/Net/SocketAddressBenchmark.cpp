@@ -0,0 +1,57 @@
+// File: SocketAddressBenchmark.cpp
+// Author: Rendong Liang (Liong)
+#include "../../Include/Testing/Benchmark.hpp"
+#include "../../Include/Net/SocketAddress.hpp"
+
+using namespace LiongPlus;
+using namespace LiongPlus::Net;
+using namespace LiongPlus::Testing;
+
+_L_Benchmark_Case(SocketAddressConstructIPv4)
+{
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		IPv4EndPoint addr(0x7F000001, (uint16_t)i);
+		DoNotOptimize(addr);
+	}
+}
+
+_L_Benchmark_Case(SocketAddressConstructIPv6)
+{
+	const uint8_t loopback[16] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 };
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		IPv6EndPoint addr(loopback, (uint16_t)i);
+		DoNotOptimize(addr);
+	}
+}
+
+_L_Benchmark_Case(SocketAddressParseIPv4)
+{
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		IPv4EndPoint addr("192.168.1.1", 80);
+		DoNotOptimize(addr);
+	}
+}
+
+// What Accept and ReceiveFrom set up for every peer.
+_L_Benchmark_Case(SocketAddressConstructReceiving)
+{
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		SocketAddress addr(SocketAddress::MAX_LENGTH);
+		DoNotOptimize(addr);
+	}
+}
+
+_L_Benchmark_Case(SocketAddressCopy)
+{
+	SocketAddress source = IPv4EndPoint(0x7F000001, 8080);
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		SocketAddress copy(source);
+		DoNotOptimize(copy);
+		ClobberMemory();
+	}
+}
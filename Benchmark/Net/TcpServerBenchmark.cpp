@@ -0,0 +1,53 @@
+// File: TcpServerBenchmark.cpp
+// Author: Rendong Liang (Liong)
+#include "../../Include/Testing/Benchmark.hpp"
+#include "../../Include/Net/TcpServer.hpp"
+
+#ifdef _L_LINUX
+using namespace LiongPlus;
+using namespace LiongPlus::Net;
+using namespace LiongPlus::Testing;
+
+// A loopback address with a port that is free right now.
+static IPv4EndPoint FreeLoopbackEndPoint()
+{
+	IPv4EndPoint addr("127.0.0.1", 0);
+	Socket probe(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	probe.Bind(addr);
+	socklen_t length = sizeof(sockaddr_in);
+	if (getsockname(probe.Handle(), (sockaddr*)addr.Field(), &length) < 0)
+		throw std::runtime_error("Failed in finding a free port.");
+	return addr;
+}
+
+// Each iteration is one connection, accepted and closed by the server and awaited by the client, so the rate is connections per second.
+static void Connect(BenchmarkState& state, size_t shardCount)
+{
+	// Starting and joining the loop threads is not part of a connection.
+	state.PauseTiming();
+	auto addr = FreeLoopbackEndPoint();
+	std::unique_ptr<TcpServer> server(new TcpServer(addr, shardCount, 1024, [](EventLoop&, Socket, const SocketAddress&) {}));
+	state.ResumeTiming();
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		Socket client(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		client.Connect(addr);
+		Byte trash;
+		// Returns 0 once the server has accepted and closed the connection.
+		while (client.TryReceive(&trash, 1, 0) > 0);
+	}
+	state.PauseTiming();
+	server.reset();
+	state.ResumeTiming();
+}
+
+_L_Benchmark_Case(TcpServerConnectOneShard)
+{
+	Connect(state, 1);
+}
+
+_L_Benchmark_Case(TcpServerConnectFourShards)
+{
+	Connect(state, 4);
+}
+#endif // _L_LINUX
@@ -0,0 +1,72 @@
+// File: NullableBenchmark.cpp
+// Author: Rendong Liang (Liong)
+#include "../Include/Testing/Benchmark.hpp"
+#include "../Include/Nullable.hpp"
+
+using namespace LiongPlus;
+using namespace LiongPlus::Testing;
+
+static_assert(std::is_trivially_copyable<Nullable<int64_t>>::value, "Nullable of a trivially copyable type should be copied with plain memory copies.");
+
+// A value as large as a typical parsed header field, so that a copy is not free.
+struct Field
+{
+	int64_t Offset, Length, Hash, Flags;
+
+	bool operator==(const Field& field) const
+	{
+		return Offset == field.Offset && Length == field.Length && Hash == field.Hash && Flags == field.Flags;
+	}
+};
+
+_L_Benchmark_Case(NullableConstruct)
+{
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		Nullable<Field> value(Field { (int64_t)i, 16, 0, 0 });
+		DoNotOptimize(value);
+	}
+}
+
+_L_Benchmark_Case(NullableConstructString)
+{
+	std::string source(64, 'x');
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		Nullable<std::string> value(source);
+		DoNotOptimize(value);
+	}
+}
+
+_L_Benchmark_Case(NullableCopy)
+{
+	Nullable<Field> source(Field { 1, 16, 0, 0 });
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		Nullable<Field> copy(source);
+		DoNotOptimize(copy);
+		ClobberMemory();
+	}
+}
+
+_L_Benchmark_Case(NullableCopyString)
+{
+	Nullable<std::string> source(std::string(64, 'x'));
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		Nullable<std::string> copy(source);
+		DoNotOptimize(copy);
+	}
+}
+
+_L_Benchmark_Case(NullableCompare)
+{
+	Nullable<Field> lhs(Field { 1, 16, 0, 0 }), rhs(Field { 1, 16, 0, 0 }), empty;
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		DoNotOptimize(lhs == rhs);
+		DoNotOptimize(lhs == empty);
+		DoNotOptimize(empty == nullptr);
+		ClobberMemory();
+	}
+}
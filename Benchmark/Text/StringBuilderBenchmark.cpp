@@ -0,0 +1,32 @@
+// File: StringBuilderBenchmark.cpp
+// Author: Rendong Liang (Liong)
+#include "../../Include/Testing/Benchmark.hpp"
+#include "../../Include/Text/StringBuilder.hpp"
+
+using namespace LiongPlus;
+using namespace LiongPlus::Testing;
+using namespace LiongPlus::Text;
+
+_L_Benchmark_Case(StringBuilderAppend)
+{
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		StringBuilder builder;
+		for (int j = 0; j < 64; ++j)
+			builder.Append((_L_Char)'#').Append(j);
+		auto str = builder.ToString();
+		DoNotOptimize(str);
+	}
+}
+
+_L_Benchmark_Case(StringBuilderAppendPresized)
+{
+	for (size_t i = 0; i < state.Iterations(); ++i)
+	{
+		StringBuilder builder(256);
+		for (int j = 0; j < 64; ++j)
+			builder.Append((_L_Char)'#').Append(j);
+		auto str = builder.ToString();
+		DoNotOptimize(str);
+	}
+}
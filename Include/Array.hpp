@@ -4,6 +4,7 @@
 #ifndef _L_Array
 #define _L_Array
 #include "Fundamental.hpp"
+#include "Memory/MemoryResource.hpp"
 
 namespace LiongPlus
 {
@@ -14,35 +15,43 @@ namespace LiongPlus
 		Array()
 			: _Size(0)
 			, _Ptr(nullptr)
+			, _Resource(Memory::MemoryResource::Default())
 		{
 		}
-		Array(const size_t size)
+		/*
+		 * [param] resource Where elements are allocated from. It must outlive the array.
+		 */
+		Array(const size_t size, Memory::MemoryResource* resource = Memory::MemoryResource::Default())
 			: _Size(size)
-			, _Ptr(new T[size])
+			, _Ptr(Memory::NewArray<T>(resource, size, Site()))
+			, _Resource(resource)
 		{
 		}
-		Array(const T* pointer, size_t size)
+		Array(const T* pointer, size_t size, Memory::MemoryResource* resource = Memory::MemoryResource::Default())
 			: _Size(size)
-			, _Ptr(new T[size])
+			, _Ptr(Memory::NewArray<T>(resource, size, Site()))
+			, _Resource(resource)
 		{
-			while (size-- > 0)
-				*(_Ptr + size) = *(pointer + size);
+			CopyElements(pointer, _Ptr, size);
 		}
+		/*
+		 * Deep copy into the default resource. Use Clone() to pick another one, or move to transfer the elements.
+		 */
 		Array(const Array<T>& instance)
-			: _Size(instance._Size)
-			, _Ptr(new T[instance._Size])
+			: Array(instance._Ptr, instance._Size)
 		{
-			Copy(instance, *this, 0);
 		}
 		Array(Array<T>&& instance)
 			: Array()
 		{
 			swap(_Size, instance._Size);
 			swap(_Ptr, instance._Ptr);
+			swap(_Resource, instance._Resource);
 		}
-		Array(const std::initializer_list<T> initList)
+		Array(const std::initializer_list<T> initList, Memory::MemoryResource* resource = Memory::MemoryResource::Default())
 			: _Size(initList.size())
-			, _Ptr(new T[initList.size()])
+			, _Ptr(Memory::NewArray<T>(resource, initList.size(), Site()))
+			, _Resource(resource)
 		{
 			size_t i = 0;
 			for (auto t : initList)
@@ -53,24 +62,27 @@ namespace LiongPlus
 			CleanUp();
 		}
 
+		/*
+		 * Deep copy into the resource of this array. The previous elements are freed only after the copy succeeds, so self-assignment is safe.
+		 */
 		Array<T>& operator=(const Array<T>& instance)
 		{
-			CleanUp();
-			_Size = instance._Size;
-			_Ptr = instance._Ptr;
+			if (this != &instance)
+				*this = Array<T>(instance._Ptr, instance._Size, _Resource);
 			return *this;
 		}
 		Array<T>& operator=(Array<T>&& instance)
 		{
 			swap(_Size, instance._Size);
 			swap(_Ptr, instance._Ptr);
+			swap(_Resource, instance._Resource);
 			return *this;
 		}
 		Array<T>& operator=(std::initializer_list<T>& initList)
 		{
 			CleanUp();
 			_Size = initList.size();
-			T* field = new T[_Size];
+			T* field = Memory::NewArray<T>(_Resource, _Size, Site());
 			size_t i = 0;
 			for (auto t : initList)
 				field[i++] = t;
@@ -78,6 +90,79 @@ namespace LiongPlus
 			return *this;
 		}
 
+		Array<T> Clone(Memory::MemoryResource* resource = Memory::MemoryResource::Default()) const
+		{
+			return Array<T>(_Ptr, _Size, resource);
+		}
+
+		/*
+		 * Reallocate to $size elements from the same resource, keeping the first ones. Elements are moved, not copied, and trivially copyable ones are relocated with a single memcpy. Elements past the old size are default-initialized, i.e. left indeterminate for PODs.
+		 * [note] If an element fails to move over, the new storage is freed and the array is left as it was. Elements whose move may throw are copied instead when they can be, as std::vector does, so none of them is left half moved.
+		 */
+		void Resize(size_t size)
+		{
+			if (size == _Size)
+				return;
+			T* field = Memory::NewArray<T>(_Resource, size, Site());
+			size_t kept = size < _Size ? size : _Size;
+			if (std::is_trivially_copyable<T>::value)
+			{
+				if (kept > 0)
+					std::memcpy(field, _Ptr, kept * sizeof(T));
+			}
+			else
+			{
+				try
+				{
+					for (size_t i = 0; i < kept; ++i)
+					{
+						if constexpr (std::is_nothrow_move_assignable<T>::value || !std::is_copy_assignable<T>::value)
+							field[i] = std::move(_Ptr[i]);
+						else
+							field[i] = _Ptr[i];
+					}
+				}
+				catch (...)
+				{
+					Memory::DeleteArray(_Resource, field, size, Site());
+					throw;
+				}
+			}
+			CleanUp();
+			_Ptr = field;
+			_Size = size;
+		}
+
+		/*
+		 * Copy $length elements between arrays, or within one; the ranges may overlap.
+		 */
+		static void Copy(const Array<T>& sourceArray, size_t sourceIndex, Array<T>& destinationArray, size_t destinationIndex, size_t length)
+		{
+			assert(sourceIndex + length <= sourceArray._Size && destinationIndex + length <= destinationArray._Size);
+
+			T* src = sourceArray._Ptr + sourceIndex;
+			T* dst = destinationArray._Ptr + destinationIndex;
+			if (std::is_trivially_copyable<T>::value)
+			{
+				if (length > 0)
+					std::memmove(dst, src, length * sizeof(T));
+			}
+			else if (dst < src)
+			{
+				for (size_t i = 0; i < length; ++i)
+					dst[i] = src[i];
+			}
+			else
+			{
+				while (length-- > 0)
+					dst[length] = src[length];
+			}
+		}
+		static void Copy(const Array<T>& sourceArray, Array<T>& destinationArray, size_t length)
+		{
+			Copy(sourceArray, 0, destinationArray, 0, length);
+		}
+
 		T& operator[](size_t index) const
 		{
 			assert(index >= 0 && index < _Size, "index");
@@ -127,6 +212,11 @@ namespace LiongPlus
 			return _Ptr;
 		}
 
+		Memory::MemoryResource* Resource() const
+		{
+			return _Resource;
+		}
+
 		T& GetValue(size_t index) const
 		{
 			assert(index >= 0, "Need non-negative number.");
@@ -166,15 +256,35 @@ namespace LiongPlus
 
 		size_t _Size;
 		T* _Ptr;
+		Memory::MemoryResource* _Resource;
 		
+		static const Memory::AllocationSite& Site()
+		{
+			return _L_Allocation_Site("Array");
+		}
+
+		static void CopyElements(const T* src, T* dst, size_t count)
+		{
+			if (std::is_trivially_copyable<T>::value)
+			{
+				if (count > 0)
+					std::memcpy(dst, src, count * sizeof(T));
+			}
+			else
+			{
+				for (size_t i = 0; i < count; ++i)
+					dst[i] = src[i];
+			}
+		}
+
 		void CleanUp()
 		{
-			_Size = 0;
 			if (_Ptr)
 			{
-				delete [] _Ptr;
+				Memory::DeleteArray(_Resource, _Ptr, _Size, Site());
 				_Ptr = nullptr;
 			}
+			_Size = 0;
 		}
 
 	};
@@ -2,47 +2,97 @@
 // Author: Rendong Liang (Liong)
 
 #include "Buffer.hpp"
+#include "Diagnostics/Metrics.hpp"
 
 namespace LiongPlus
 {
 	using std::swap;
 
+	static const Memory::AllocationSite _Site = { "Buffer", __FILE__, __LINE__ };
+
+	static Diagnostics::Counter& AllocatedBytes()
+	{
+		static auto& counter = Diagnostics::MetricsRegistry::Default().GetCounter("liong_buffer_allocated_bytes_total", "Bytes allocated by buffers.");
+		return counter;
+	}
+	static void CountAllocation(size_t length)
+	{
+		static auto& count = Diagnostics::MetricsRegistry::Default().GetCounter("liong_buffer_allocations_total", "Buffers allocated.");
+		count.Add();
+		AllocatedBytes().Add(length);
+	}
+	// Growth of an existing buffer; only the added bytes count as allocated.
+	static void CountReallocation(size_t growth)
+	{
+		static auto& count = Diagnostics::MetricsRegistry::Default().GetCounter("liong_buffer_reallocations_total", "Buffers grown by reallocation.");
+		count.Add();
+		AllocatedBytes().Add(growth);
+	}
+
 	Buffer::Buffer()
 		: _Field(nullptr)
 		, _Length(0)
+		, _Capacity(0)
+		, _Alignment(1)
+		, _Resource(Memory::MemoryResource::Default())
 	{
 	}
 	Buffer::Buffer(size_t length)
-		: _Field(new Byte[length])
+		: Buffer(length, Memory::MemoryResource::Default())
+	{
+	}
+	Buffer::Buffer(size_t length, Memory::MemoryResource* resource)
+		: Buffer(length, (size_t)1, resource)
+	{
+	}
+	Buffer::Buffer(size_t length, BufferInitialization initialization, Memory::MemoryResource* resource)
+		: Buffer(length, (size_t)1, resource)
+	{
+		if (initialization == BufferInitialization::Zeroed)
+			Wipe();
+	}
+	Buffer::Buffer(size_t length, size_t alignment, Memory::MemoryResource* resource)
+		: _Field(nullptr)
 		, _Length(length)
+		, _Capacity(length)
+		, _Alignment(alignment)
+		, _Resource(resource)
 	{
+		if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+			throw std::runtime_error("$alignment is not a power of two.");
+		_Field = static_cast<Byte*>(resource->Allocate(length, alignment, _Site));
+		CountAllocation(length);
 	}
 	Buffer::Buffer(const Buffer& instance)
-		: _Field(nullptr)
-		, _Length(0)
+		: Buffer()
 	{
 		*this = instance.Clone();
 	}
 	Buffer::Buffer(Buffer&& instance)
 		: Buffer()
 	{
-		swap(_Field, instance._Field);
-		swap(_Length, instance._Length);
+		swap(*this, instance);
 	}
 	Buffer::Buffer(const char* str)
-		: _Length(strlen(str) + 1)
-		, _Field(new char[_Length])
+		: _Field(nullptr)
+		, _Length(strlen(str) + 1)
+		, _Capacity(_Length)
+		, _Alignment(1)
+		, _Resource(Memory::MemoryResource::Default())
 	{
+		_Field = static_cast<Byte*>(_Resource->Allocate(_Length, 1, _Site));
 		strcpy(_Field, str);
+		CountAllocation(_Length);
 	}
 	Buffer::~Buffer()
 	{
 		if (_Field != nullptr)
 		{
-			delete[] _Field;
+			_Resource->Deallocate(_Field, _Capacity, _Alignment, _Site);
 			_Field = nullptr;
 		}
 		_Length = 0;
+		_Capacity = 0;
 	}
 
 
@@ -53,8 +103,7 @@ namespace LiongPlus
 	}
 	Buffer& Buffer::operator=(Buffer&& instance)
 	{
-		swap(_Field, instance._Field);
-		swap(_Length, instance._Length);
+		swap(*this, instance);
 		return *this;
 	}
 	Byte& Buffer::operator[](size_t index)
@@ -71,7 +120,11 @@ namespace LiongPlus
 
 	Buffer Buffer::Clone() const
 	{
-		Buffer buffer(_Length);
+		return Clone(Memory::MemoryResource::Default());
+	}
+	Buffer Buffer::Clone(Memory::MemoryResource* resource) const
+	{
+		Buffer buffer(_Length, _Alignment, resource);
 		std::memcpy(buffer._Field, _Field, _Length);
 
 		return buffer;
@@ -82,6 +135,39 @@ namespace LiongPlus
 		return _Length;
 	}
 
+	size_t Buffer::Capacity() const
+	{
+		return _Capacity;
+	}
+
+	size_t Buffer::Alignment() const
+	{
+		return _Alignment;
+	}
+
+	Memory::MemoryResource* Buffer::Resource() const
+	{
+		return _Resource;
+	}
+
+	void Buffer::Reserve(size_t capacity)
+	{
+		if (capacity <= _Capacity)
+			return;
+		_Field = static_cast<Byte*>(_Resource->Reallocate(_Field, _Capacity, capacity, _Alignment, _Site));
+		if (_Capacity == 0)
+			CountAllocation(capacity);
+		else
+			CountReallocation(capacity - _Capacity);
+		_Capacity = capacity;
+	}
+
+	void Buffer::Resize(size_t length)
+	{
+		Reserve(length);
+		_Length = length;
+	}
+
 	Byte* Buffer::Field()
 	{
 		return _Field;
@@ -3,9 +3,17 @@
 
 #pragma once
 #include "Fundamental.hpp"
+#include "Memory/MemoryResource.hpp"
 
 namespace LiongPlus
 {
+	enum class BufferInitialization
+	{
+		// Content is indeterminate; for buffers about to be overwritten anyway.
+		Uninitialized,
+		Zeroed
+	};
+
 	class Buffer
 	{
 		friend void swap(Buffer& x, Buffer& y)
@@ -13,15 +21,34 @@ namespace LiongPlus
 			using std::swap;
 			swap(x._Field, y._Field);
 			swap(x._Length, y._Length);
+			swap(x._Capacity, y._Capacity);
+			swap(x._Alignment, y._Alignment);
+			swap(x._Resource, y._Resource);
 		}
 	private:
 		Byte* _Field;
 		size_t _Length;
+		// Bytes allocated, no less than $_Length.
+		size_t _Capacity;
+		size_t _Alignment;
+		Memory::MemoryResource* _Resource;
 	public:
 		Buffer();
 		Buffer(const Buffer&);
 		Buffer(Buffer&&);
+		/*
+		 * Allocate $length uninitialized bytes.
+		 */
 		Buffer(size_t length);
+		/*
+		 * Allocate $length bytes from $resource, which must outlive the buffer.
+		 */
+		Buffer(size_t length, Memory::MemoryResource* resource);
+		Buffer(size_t length, BufferInitialization initialization, Memory::MemoryResource* resource = Memory::MemoryResource::Default());
+		/*
+		 * Allocate $length uninitialized bytes starting at a multiple of $alignment, a power of two, e.g. 64 for SIMD or 4096 for O_DIRECT. Resizing keeps the alignment.
+		 */
+		Buffer(size_t length, size_t alignment, Memory::MemoryResource* resource = Memory::MemoryResource::Default());
 		Buffer(const char* str);
 		~Buffer();
 
@@ -30,10 +57,25 @@ namespace LiongPlus
 		Byte& operator[](size_t index);
 		
 		void CopyTo(void* dst, size_t index, size_t count) const;
+		/*
+		 * [return] A copy allocated from the default resource, like copy construction.
+		 */
 		Buffer Clone() const;
+		Buffer Clone(Memory::MemoryResource* resource) const;
 		Byte* Field();
 		const Byte* Field() const;
 		size_t Length() const;
+		size_t Capacity() const;
+		size_t Alignment() const;
+		Memory::MemoryResource* Resource() const;
+		/*
+		 * Make room for $capacity bytes without changing the length. Resources that map memory grow it in place with mremap(2) where possible.
+		 */
+		void Reserve(size_t capacity);
+		/*
+		 * Change the length, keeping the content up to the shorter length. Bytes past the old length are uninitialized. Storage grows exactly to $length, so reserve ahead for repeated growth.
+		 */
+		void Resize(size_t length);
 		void Wipe();
 	};
 }
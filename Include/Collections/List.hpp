@@ -28,7 +28,7 @@ namespace LiongPlus
 
 		public:
 			List()
-				: _Data(new T[_InitialCapacity], _InitialCapacity)
+				: _Data(_InitialCapacity)
 				, _Count(new long(0))
 			{
 			}
@@ -49,8 +49,11 @@ namespace LiongPlus
 			{
 				AddRange(source);
 			}
-			List(long capacity)
-				: _Data(new T[capacity])
+			/*
+			 * [param] resource Where elements are allocated from, also when the list grows. It must outlive the list.
+			 */
+			List(long capacity, Memory::MemoryResource* resource = Memory::MemoryResource::Default())
+				: _Data(capacity, resource)
 				, _Count(new long(0))
 			{
 			}
@@ -146,9 +149,7 @@ namespace LiongPlus
 			{
 				if (value <= _Data.GetCount())
 					return false;
-				Array<T> newData(value);
-				_Data.CopyTo(newData, 0);
-				_Data = newData;
+				_Data.Resize(value);
 				return true;
 			}
 			void Sort()
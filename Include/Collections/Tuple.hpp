@@ -3,88 +3,158 @@
 #ifndef _L_Tuple
 #define _L_Tuple
 #include "../Fundamental.hpp"
-#include "../Buffer.hpp"
 
 namespace LiongPlus
 {
 	namespace Collections
 	{
+		namespace Detail
+		{
+			struct TupleLeafTag {};
+			template<bool ... Bs>
+			struct BoolPack {};
+
+			/*
+			 * One field of a tuple. The index keeps leaves of the same type apart.
+			 */
+			template<size_t I, typename T>
+			struct TupleLeaf
+			{
+				T Value{};
+
+				TupleLeaf() = default;
+				template<typename U>
+				constexpr TupleLeaf(TupleLeafTag, U&& value)
+					: Value(std::forward<U>(value))
+				{
+				}
+			};
+
+			template<typename TIndices, typename ... Ts>
+			struct TupleImpl;
+			/*
+			 * Leaves are laid out as sequential bases, so the compiler places every field at an aligned offset exactly as it would in a plain struct with the same members.
+			 */
+			template<size_t ... Is, typename ... Ts>
+			struct TupleImpl<std::index_sequence<Is ...>, Ts ...>
+				: TupleLeaf<Is, Ts> ...
+			{
+				TupleImpl() = default;
+				template<typename ... Us>
+				constexpr TupleImpl(TupleLeafTag tag, Us&& ... args)
+					: TupleLeaf<Is, Ts>(tag, std::forward<Us>(args)) ...
+				{
+				}
+			};
+		}
+
+		/*
+		 * A fixed-size heterogeneous collection with fields stored inline.
+		 * Field offsets are decided at compile time with regard to alignment, and a tuple of trivially copyable types is trivially copyable itself.
+		 */
 		template<typename ... Ts>
 		class Tuple
-			: public Object
 		{
-		public:
-			using TSelf = Tuple<Ts ...>;
+		private:
+			using TImpl = Detail::TupleImpl<std::index_sequence_for<Ts ...>, Ts ...>;
 
-			Tuple()
-			{
-				_Anchors[0] = new Byte[GetDataLength()];
-				Byte** pos = reinterpret_cast<Byte**>(_Anchors);
-				Byte* fieldPos = reinterpret_cast<Byte*>(_Anchors[0]);
-				long i[] = { 0, (*(pos++) = fieldPos, fieldPos += sizeof(Ts), *(reinterpret_cast<Ts*>(fieldPos)) = args, 0)... };
-			}
-			Tuple(const Ts& ... args)
+			TImpl _Impl;
+
+			template<size_t ... Is>
+			bool Equals(const Tuple<Ts ...>& instance, std::index_sequence<Is ...>) const
 			{
-				_Anchors[0] = new Byte[GetDataLength()];
-				Byte** pos = reinterpret_cast<Byte**>(_Anchors);
-				Byte* fieldPos = reinterpret_cast<Byte*>(_Anchors[0]);
-				long i[] = { 0, (*(pos++) = fieldPos, *(reinterpret_cast<Ts*>(fieldPos)) = args, fieldPos += sizeof(Ts), 0)... };
+				bool rv = true;
+				long i[] = { 0, (rv = rv && Get<Is>() == instance.template Get<Is>(), 0) ... };
+				(void)i;
+				return rv;
 			}
-			Tuple(const TSelf& instance)
+			template<typename T, size_t ... Is>
+			T& GetValue(long index, std::index_sequence<Is ...>)
 			{
-				Buffer::Memcpy(_Anchors[0], instance._Anchors[0], GetDataLength());
+				// The leading entries keep the arrays valid for an empty tuple.
+				void* fields[] = { nullptr, static_cast<void*>(&Get<Is>()) ... };
+				bool isCorrectType[] = { false, std::is_same<T, Ts>::value ... };
+				if (index < 0 || index >= (long)sizeof...(Ts) || !isCorrectType[index + 1])
+					throw std::runtime_error("Invalid $index or type.");
+				return *static_cast<T*>(fields[index + 1]);
 			}
-			Tuple(TSelf&& instance)
+		public:
+			using TSelf = Tuple<Ts ...>;
+			template<size_t I>
+			using TElement = typename std::tuple_element<I, std::tuple<Ts ...>>::type;
+
+			Tuple() = default;
+			template<bool TIsNotEmpty = sizeof...(Ts) != 0, typename = typename std::enable_if<TIsNotEmpty>::type>
+			constexpr Tuple(const Ts& ... args)
+				: _Impl(Detail::TupleLeafTag(), args ...)
 			{
-				Buffer::Memxchg(_Anchors[0], instance._Anchors[0], GetDataLength());
 			}
-			~Tuple()
+			template<typename ... Us, typename = typename std::enable_if<
+				sizeof...(Us) == sizeof...(Ts) && sizeof...(Us) != 0 &&
+				std::is_same<Detail::BoolPack<true, std::is_constructible<Ts, Us&&>::value ...>, Detail::BoolPack<std::is_constructible<Ts, Us&&>::value ..., true>>::value &&
+				!std::is_same<std::tuple<typename std::decay<Us>::type ...>, std::tuple<TSelf>>::value
+			>::type>
+			constexpr Tuple(Us&& ... args)
+				: _Impl(Detail::TupleLeafTag(), std::forward<Us>(args) ...)
 			{
-				delete [] (Byte*)(_Anchors[0]);
 			}
+			Tuple(const TSelf&) = default;
+			Tuple(TSelf&&) = default;
+
+			TSelf& operator=(const TSelf&) = default;
+			TSelf& operator=(TSelf&&) = default;
 
-			TSelf operator=(const TSelf& instance)
+			bool operator==(const TSelf& instance) const
 			{
-				Buffer::Memcpy(_Anchors[0], instance._Anchors[0], GetDataLength());
-				return *this;
+				return Equals(instance, std::index_sequence_for<Ts ...>());
 			}
-			TSelf operator=(TSelf&& instance)
+			bool operator!=(const TSelf& instance) const
 			{
-				Buffer::Memxchg(_Anchors[0], instance._Anchors[0], GetDataLength());
-				return *this;
+				return !Equals(instance, std::index_sequence_for<Ts ...>());
 			}
-			bool operator=(TSelf& value)
+
+			template<size_t I>
+			constexpr TElement<I>& Get()
 			{
-				return std::memcmp(_Anchors[0], value._Anchors[0], GetDataLength()) == 0;
+				return static_cast<Detail::TupleLeaf<I, TElement<I>>&>(_Impl).Value;
 			}
-
-			long GetDataLength() const
+			template<size_t I>
+			constexpr const TElement<I>& Get() const
 			{
-				long len = 0;
-				long i[] = { 0, (len += sizeof(Ts), 0)... };
-				return len;
+				return static_cast<const Detail::TupleLeaf<I, TElement<I>>&>(_Impl).Value;
 			}
 
+			/*
+			 * Access a field with an index known only at run time. Throw if $index is out of range or the field is not of type $T.
+			 */
 			template<typename T>
-			bool IsCorrectType(long index)
+			T& GetValue(long index)
 			{
-				bool flag = false;
-				long pos = 0;
-				long i[] = { 0, (flag = flag || (pos++ == index ? typeid(T) == typeid(Ts) : false), 0)... };
-				return flag;
+				return GetValue<T>(index, std::index_sequence_for<Ts ...>());
 			}
 
-			template<typename T>
-			T& GetValue(long index)
+			static constexpr size_t Count()
 			{
-				assert(index < sizeof...(Ts), "$index");
-				assert(IsCorrectType<T>(index), "$index");
-				
-				return *reinterpret_cast<T*>(_Anchors[index]);
+				return sizeof...(Ts);
 			}
-			
-			void* _Anchors[sizeof...(Ts)];
 		};
+
+		template<size_t I, typename ... Ts>
+		constexpr typename Tuple<Ts ...>::template TElement<I>& Get(Tuple<Ts ...>& tuple)
+		{
+			return tuple.template Get<I>();
+		}
+		template<size_t I, typename ... Ts>
+		constexpr const typename Tuple<Ts ...>::template TElement<I>& Get(const Tuple<Ts ...>& tuple)
+		{
+			return tuple.template Get<I>();
+		}
+
+		template<typename ... Ts>
+		Tuple<typename std::decay<Ts>::type ...> MakeTuple(Ts&& ... args)
+		{
+			return Tuple<typename std::decay<Ts>::type ...>(std::forward<Ts>(args) ...);
+		}
 	}
 }
-#endif
\ No newline at end of file
+#endif
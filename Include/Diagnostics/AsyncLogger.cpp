@@ -0,0 +1,412 @@
+// File: AsyncLogger.cpp
+// Author: Rendong Liang (Liong)
+#include "AsyncLogger.hpp"
+#include "../DateTime.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#ifdef _L_MSVC
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define _L_AsyncLogger_Tsc
+#endif
+
+namespace LiongPlus
+{
+	namespace Diagnostics
+	{
+		using namespace std::chrono;
+
+		static int64_t SteadyNow()
+		{
+			return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+		}
+		// The time stamp counter is read without leaving user space, even on virtual machines where the clocks are not. Elsewhere ticks are nanoseconds of the steady clock.
+		static inline uint64_t Ticks()
+		{
+#ifdef _L_AsyncLogger_Tsc
+			return __rdtsc();
+#else
+			return (uint64_t)SteadyNow();
+#endif
+		}
+
+		namespace Detail
+		{
+			LogRing::LogRing(size_t capacity)
+				: _Data()
+				, _Capacity(4096)
+				, _Head(0)
+				, _Tail(0)
+				, IsOrphaned(false)
+			{
+				// Offsets are masked rather than divided, so the capacity is a power of two.
+				while (_Capacity < capacity)
+					_Capacity <<= 1;
+				_Data.reset(new Byte[_Capacity]);
+			}
+
+			size_t LogRing::Capacity() const
+			{
+				return _Capacity;
+			}
+
+			Byte* LogRing::Reserve(size_t size)
+			{
+				auto head = _Head.load(std::memory_order_relaxed);
+				auto tail = _Tail.load(std::memory_order_acquire);
+				size_t offset = head & (_Capacity - 1);
+				// A record never wraps around. If it does not fit before the end, the rest of the ring is skipped.
+				size_t padding = _Capacity - offset < size ? _Capacity - offset : 0;
+				if (head + padding + size - tail > _Capacity)
+					return nullptr;
+				if (padding != 0)
+				{
+					memcpy(_Data.get() + offset, &PADDING, sizeof(PADDING));
+					_Head.store(head + padding, std::memory_order_release);
+					offset = 0;
+				}
+				return _Data.get() + offset;
+			}
+			void LogRing::Commit(size_t size)
+			{
+				_Head.store(_Head.load(std::memory_order_relaxed) + size, std::memory_order_release);
+			}
+
+			size_t LogRing::Drain(const Action<const Byte*, size_t>& consume)
+			{
+				auto tail = _Tail.load(std::memory_order_relaxed);
+				auto head = _Head.load(std::memory_order_acquire);
+				size_t count = 0;
+				while (tail != head)
+				{
+					size_t offset = tail & (_Capacity - 1);
+					uint32_t size;
+					memcpy(&size, _Data.get() + offset, sizeof(size));
+					if (size == PADDING)
+					{
+						tail += _Capacity - offset;
+						continue;
+					}
+					consume(_Data.get() + offset, size);
+					tail += size;
+					++count;
+				}
+				_Tail.store(tail, std::memory_order_release);
+				return count;
+			}
+
+			bool LogRing::IsEmpty() const
+			{
+				return _Tail.load(std::memory_order_acquire) == _Head.load(std::memory_order_acquire);
+			}
+		}
+
+
+
+		static std::atomic<uint64_t> _NextLoggerId(1);
+		static std::atomic<AsyncLogger*> _DefaultLogger(nullptr);
+
+		AsyncLogger::AsyncLogger(IO::Stream& stream)
+			: AsyncLogger(stream, 64 * 1024, OverflowPolicy::Drop)
+		{
+		}
+		AsyncLogger::AsyncLogger(IO::Stream& stream, size_t ringCapacity, OverflowPolicy policy)
+			: _Stream(stream)
+			, _RingCapacity(ringCapacity)
+			, _Policy(policy)
+			, _Id(_NextLoggerId++)
+			, _DroppedCount(0)
+			, _BaseTicks(Ticks())
+			, _BaseSteady(SteadyNow())
+			, _BaseSystem(duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count())
+			, _NsPerTick(1.0)
+			, _Mutex()
+			, _Cond()
+			, _Rings()
+			, _FlushRequested(0)
+			, _FlushCompleted(0)
+			, _ShouldExit(false)
+			, _Thread()
+		{
+			_Thread = std::thread([this] { Work(); });
+		}
+		AsyncLogger::~AsyncLogger()
+		{
+			AsyncLogger* self = this;
+			_DefaultLogger.compare_exchange_strong(self, nullptr);
+			{
+				std::lock_guard<std::mutex> lock(_Mutex);
+				_ShouldExit = true;
+			}
+			_Cond.notify_all();
+			_Thread.join();
+		}
+
+		void AsyncLogger::Flush()
+		{
+			std::unique_lock<std::mutex> lock(_Mutex);
+			auto ticket = ++_FlushRequested;
+			_Cond.notify_all();
+			_Cond.wait(lock, [this, ticket] { return _FlushCompleted >= ticket; });
+		}
+
+		uint64_t AsyncLogger::DroppedCount() const
+		{
+			return _DroppedCount.load(std::memory_order_relaxed);
+		}
+
+		AsyncLogger* AsyncLogger::Default()
+		{
+			return _DefaultLogger.load(std::memory_order_acquire);
+		}
+		void AsyncLogger::SetDefault(AsyncLogger* logger)
+		{
+			_DefaultLogger.store(logger, std::memory_order_release);
+		}
+
+		const char* AsyncLogger::LevelName(LogLevel level)
+		{
+			static const char* const NAMES[] = { "TRACE", "DEBUG", "INFO", "WARN", "ERROR" };
+			return NAMES[(int)level];
+		}
+
+		// Private
+
+		Detail::LogRing& AsyncLogger::GetRing()
+		{
+			struct RingCache
+			{
+				// Most recently used first. A thread seldom logs to more than a couple of loggers, so a scan beats a map.
+				std::vector<std::pair<uint64_t, std::shared_ptr<Detail::LogRing>>> Rings;
+
+				~RingCache()
+				{
+					// The logger frees the ring once it has drained it.
+					for (auto& ring : Rings)
+						ring.second->IsOrphaned = true;
+				}
+			};
+			static thread_local RingCache cache;
+
+			auto& rings = cache.Rings;
+			if (!rings.empty() && rings.front().first == _Id)
+				return *rings.front().second;
+			for (size_t i = 1; i < rings.size(); ++i)
+			{
+				if (rings[i].first == _Id)
+				{
+					std::rotate(rings.begin(), rings.begin() + i, rings.begin() + i + 1);
+					return *rings.front().second;
+				}
+			}
+
+			if (rings.size() >= MAX_CACHED_RINGS)
+			{
+				rings.back().second->IsOrphaned = true;
+				rings.pop_back();
+			}
+			auto ring = std::make_shared<Detail::LogRing>(_RingCapacity);
+			{
+				std::lock_guard<std::mutex> lock(_Mutex);
+				_Rings.push_back(ring);
+			}
+			rings.emplace(rings.begin(), _Id, ring);
+			return *ring;
+		}
+
+		Byte* AsyncLogger::Begin(const LogSite& site, size_t size, uint32_t count, Detail::LogRing*& ring)
+		{
+			ring = &GetRing();
+			// A record larger than this could wait for space forever.
+			if (size > ring->Capacity() / 2)
+			{
+				_DroppedCount.fetch_add(1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			Byte* pos;
+			while ((pos = ring->Reserve(size)) == nullptr)
+			{
+				if (_Policy == OverflowPolicy::Drop)
+				{
+					_DroppedCount.fetch_add(1, std::memory_order_relaxed);
+					return nullptr;
+				}
+				std::this_thread::yield();
+			}
+
+			uint32_t size32 = (uint32_t)size;
+			const LogSite* sitePtr = &site;
+			uint64_t ticks = Ticks();
+			memcpy(pos, &size32, 4);
+			memcpy(pos + 4, &count, 4);
+			memcpy(pos + 8, &sitePtr, 8);
+			memcpy(pos + 16, &ticks, 8);
+			return pos + RECORD_HEADER_LENGTH;
+		}
+
+		void AsyncLogger::Calibrate()
+		{
+#ifdef _L_AsyncLogger_Tsc
+			// Measured over the whole lifetime of the logger, so the rate only gets more precise.
+			auto ticks = Ticks();
+			auto steady = SteadyNow();
+			if (ticks > _BaseTicks && steady > _BaseSteady)
+				_NsPerTick = (double)(steady - _BaseSteady) / (double)(ticks - _BaseTicks);
+#endif
+		}
+
+		size_t AsyncLogger::DrainAll(std::string& text, time_t& lastSecond, std::string& lastTime)
+		{
+			std::vector<std::shared_ptr<Detail::LogRing>> rings;
+			{
+				std::lock_guard<std::mutex> lock(_Mutex);
+				rings = _Rings;
+			}
+
+			size_t count = 0;
+			text.clear();
+			for (auto& ring : rings)
+			{
+				count += ring->Drain([&](const Byte* record, size_t)
+				{
+					Format(record, text, lastSecond, lastTime);
+				});
+			}
+			// One write per pass rather than per line.
+			if (!text.empty())
+				_Stream.Write(&text[0], text.size());
+			return count;
+		}
+
+		void AsyncLogger::Format(const Byte* record, std::string& text, time_t& lastSecond, std::string& lastTime)
+		{
+			const LogSite* site;
+			uint64_t ticks;
+			memcpy(&site, record + 8, 8);
+			memcpy(&ticks, record + 16, 8);
+			// Signed, as a record may be stamped before the logger on another core whose counter runs slightly behind.
+			int64_t timestamp = _BaseSystem + (int64_t)((double)(int64_t)(ticks - _BaseTicks) * _NsPerTick);
+
+			// Records come in bursts, so the date part is formatted once a second at most.
+			time_t second = (time_t)(timestamp / 1000000000);
+			if (second != lastSecond)
+			{
+				lastTime = DateTime::GetCustomized("%Y-%m-%d %H:%M:%S", second);
+				lastSecond = second;
+			}
+			char buffer[64];
+			snprintf(buffer, sizeof(buffer), ".%03d ", (int)(timestamp / 1000000 % 1000));
+			text += lastTime;
+			text += buffer;
+			text += '[';
+			text += LevelName(site->Level);
+			text += "] ";
+			auto file = strrchr(site->File, '/');
+			if (file == nullptr)
+				file = strrchr(site->File, '\\');
+			text += file != nullptr ? file + 1 : site->File;
+			text += ':';
+			text += std::to_string(site->Line);
+			text += ' ';
+
+			uint32_t remaining;
+			memcpy(&remaining, record + 4, 4);
+			auto pos = record + RECORD_HEADER_LENGTH;
+			for (auto format = site->Format; *format != '\0'; ++format)
+			{
+				// Placeholders beyond the arguments are kept as they are.
+				if (format[0] != '{' || format[1] != '}' || remaining == 0)
+				{
+					text += *format;
+					continue;
+				}
+				++format;
+				--remaining;
+
+				auto type = (Detail::LogArgType)*pos++;
+				if (type == Detail::LogArgType::String)
+				{
+					uint32_t argLength;
+					memcpy(&argLength, pos, 4);
+					text.append(pos + 4, argLength);
+					pos += 4 + argLength;
+					continue;
+				}
+
+				uint64_t value;
+				memcpy(&value, pos, 8);
+				pos += 8;
+				switch (type)
+				{
+				case Detail::LogArgType::Int:
+					text += std::to_string((int64_t)value);
+					break;
+				case Detail::LogArgType::UInt:
+					text += std::to_string(value);
+					break;
+				case Detail::LogArgType::Double:
+				{
+					double d;
+					memcpy(&d, &value, 8);
+					snprintf(buffer, sizeof(buffer), "%g", d);
+					text += buffer;
+					break;
+				}
+				case Detail::LogArgType::Bool:
+					text += value != 0 ? "true" : "false";
+					break;
+				case Detail::LogArgType::Char:
+					text += (char)value;
+					break;
+				case Detail::LogArgType::Pointer:
+					snprintf(buffer, sizeof(buffer), "%p", (void*)(uintptr_t)value);
+					text += buffer;
+					break;
+				default:
+					break;
+				}
+			}
+			text += '\n';
+		}
+
+		void AsyncLogger::Work()
+		{
+			std::string text;
+			time_t lastSecond = -1;
+			std::string lastTime;
+
+			std::unique_lock<std::mutex> lock(_Mutex);
+			while (true)
+			{
+				auto ticket = _FlushRequested;
+				auto isExiting = _ShouldExit;
+				lock.unlock();
+
+				Calibrate();
+				auto count = DrainAll(text, lastSecond, lastTime);
+				if (ticket > _FlushCompleted || isExiting)
+					_Stream.Flush();
+
+				lock.lock();
+				// A ring whose thread has gone will never be written again, so it can be released once empty.
+				_Rings.erase(std::remove_if(_Rings.begin(), _Rings.end(), [](const std::shared_ptr<Detail::LogRing>& ring)
+				{
+					return ring->IsOrphaned.load() && ring->IsEmpty();
+				}), _Rings.end());
+				if (ticket > _FlushCompleted)
+				{
+					_FlushCompleted = ticket;
+					_Cond.notify_all();
+				}
+				if (isExiting)
+					return;
+				// Producers never signal, to stay cheap, so poll while there is nothing to do.
+				if (count == 0 && _FlushRequested == ticket && !_ShouldExit)
+					_Cond.wait_for(lock, milliseconds(1));
+			}
+		}
+	}
+}
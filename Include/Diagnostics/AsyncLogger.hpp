@@ -0,0 +1,269 @@
+// File: AsyncLogger.hpp
+// Author: Rendong Liang (Liong)
+
+#ifndef _L_AsyncLogger
+#define _L_AsyncLogger
+#include "../Fundamental.hpp"
+#include "../IO/Stream.hpp"
+
+// Records below this level are compiled out, arguments included.
+#ifndef _L_LOG_LEVEL
+#ifdef _L_DEBUG
+#define _L_LOG_LEVEL 1
+#else
+#define _L_LOG_LEVEL 2
+#endif
+#endif
+
+namespace LiongPlus
+{
+	namespace Diagnostics
+	{
+		enum class LogLevel
+		{
+			Trace = 0,
+			Debug = 1,
+			Info = 2,
+			Warn = 3,
+			Error = 4
+		};
+
+		/*
+		 * Everything about a log statement known at compile time. One static instance lives at each call site, so records only carry its address.
+		 */
+		struct LogSite
+		{
+			LogLevel Level;
+			// Each '{}' is replaced by the next argument.
+			const char* Format;
+			const char* File;
+			int Line;
+		};
+
+		namespace Detail
+		{
+			enum class LogArgType : uint8_t
+			{
+				Int,
+				UInt,
+				Double,
+				Bool,
+				Char,
+				String,
+				Pointer
+			};
+
+			/*
+			 * An argument of a log statement, before it is encoded into a record.
+			 */
+			struct LogArg
+			{
+				LogArgType Type;
+				union
+				{
+					int64_t Int;
+					uint64_t UInt;
+					double Double;
+					const void* Pointer;
+				};
+				const char* Data;
+				size_t Length;
+
+				LogArg(bool value) : Type(LogArgType::Bool), UInt(value), Data(nullptr), Length(0) {}
+				LogArg(char value) : Type(LogArgType::Char), UInt((uint8_t)value), Data(nullptr), Length(0) {}
+				LogArg(float value) : Type(LogArgType::Double), Double(value), Data(nullptr), Length(0) {}
+				LogArg(double value) : Type(LogArgType::Double), Double(value), Data(nullptr), Length(0) {}
+				// Literals are measured at compile time once this is inlined. Pass a std::string_view to skip measuring other strings of known length.
+				LogArg(const char* value) : Type(LogArgType::String), Pointer(nullptr), Data(value), Length(value != nullptr ? strlen(value) : 0) {}
+				LogArg(char* value) : LogArg((const char*)value) {}
+				LogArg(const std::string& value) : Type(LogArgType::String), Pointer(nullptr), Data(value.data()), Length(value.size()) {}
+				LogArg(std::string_view value) : Type(LogArgType::String), Pointer(nullptr), Data(value.data()), Length(value.size()) {}
+				template<typename T, typename = typename std::enable_if<std::is_integral<T>::value>::type>
+				LogArg(T value)
+					: Type(std::is_signed<T>::value ? LogArgType::Int : LogArgType::UInt)
+					, Data(nullptr)
+					, Length(0)
+				{
+					if (std::is_signed<T>::value)
+						Int = (int64_t)value;
+					else
+						UInt = (uint64_t)value;
+				}
+				template<typename T>
+				LogArg(T* value) : Type(LogArgType::Pointer), Pointer(value), Data(nullptr), Length(0) {}
+
+				/*
+				 * [return] Bytes taken in a record: a type byte followed by 8 bytes, or by a 4-byte length and the characters for strings.
+				 */
+				size_t EncodedLength() const
+				{
+					return 1 + (Type == LogArgType::String ? 4 + Length : 8);
+				}
+				/*
+				 * [return] The position right after the encoded argument.
+				 */
+				Byte* Encode(Byte* pos) const
+				{
+					*pos++ = (Byte)Type;
+					if (Type == LogArgType::String)
+					{
+						uint32_t length = (uint32_t)Length;
+						memcpy(pos, &length, 4);
+						memcpy(pos + 4, Data, Length);
+						return pos + 4 + Length;
+					}
+					// All the other members share the storage of this one.
+					memcpy(pos, &UInt, 8);
+					return pos + 8;
+				}
+			};
+
+			/*
+			 * A single-producer single-consumer ring of variable-length records.
+			 */
+			class LogRing
+			{
+			private:
+				std::unique_ptr<Byte[]> _Data;
+				size_t _Capacity;
+				// Total bytes ever written and consumed. Only the producer stores $_Head and only the consumer stores $_Tail.
+				std::atomic<uint64_t> _Head, _Tail;
+			public:
+				static const uint32_t PADDING = 0xFFFFFFFF;
+
+				// Set once no thread writes to the ring any more, so that it is freed after being drained.
+				std::atomic<bool> IsOrphaned;
+
+				LogRing(size_t capacity);
+
+				size_t Capacity() const;
+				/*
+				 * [return] Space for a record of $size bytes, or nullptr if the ring is too full.
+				 */
+				Byte* Reserve(size_t size);
+				void Commit(size_t size);
+
+				/*
+				 * Call $consume with each committed record.
+				 * [return] Number of records consumed.
+				 */
+				size_t Drain(const Action<const Byte*, size_t>& consume);
+				bool IsEmpty() const;
+			};
+		}
+
+		/*
+		 * A logger that keeps formatting and I/O off the calling thread.
+		 * Each thread writes binary records, made of the call site and the raw arguments, into a ring of its own without locking. A background thread formats them and writes text lines to a stream.
+		 * Log through the _L_Log_* macros, which go to the default logger and skip levels below _L_LOG_LEVEL at compile time.
+		 */
+		class AsyncLogger
+		{
+		public:
+			enum class OverflowPolicy
+			{
+				// Discard the record and count it in DroppedCount().
+				Drop,
+				// Wait until the background thread frees space.
+				Block
+			};
+		private:
+			// Size (4), argument count (4), site (8) and timestamp in ticks (8), followed by the encoded arguments.
+			static const size_t RECORD_HEADER_LENGTH = 24;
+			// Rings a thread keeps for different loggers before giving up the least recently used one.
+			static const size_t MAX_CACHED_RINGS = 8;
+
+			IO::Stream& _Stream;
+			size_t _RingCapacity;
+			OverflowPolicy _Policy;
+			uint64_t _Id;
+			std::atomic<uint64_t> _DroppedCount;
+			// Ticks and wall clock time at construction, for the background thread to convert timestamps with.
+			uint64_t _BaseTicks;
+			int64_t _BaseSteady, _BaseSystem;
+			double _NsPerTick;
+
+			std::mutex _Mutex;
+			std::condition_variable _Cond;
+			std::vector<std::shared_ptr<Detail::LogRing>> _Rings;
+			uint64_t _FlushRequested, _FlushCompleted;
+			bool _ShouldExit;
+			std::thread _Thread;
+
+			Detail::LogRing& GetRing();
+			/*
+			 * Reserve a record of $size bytes for $count arguments on the ring of the calling thread, which is stored to $ring, and write its header.
+			 * [return] Where the arguments go, or nullptr if the record is dropped.
+			 */
+			Byte* Begin(const LogSite& site, size_t size, uint32_t count, Detail::LogRing*& ring);
+			template<typename TTuple, size_t ... TIndices>
+			void WriteArgs(const LogSite& site, const TTuple& args, std::index_sequence<TIndices ...>)
+			{
+				// Each argument is converted once, so a string is measured once. Inlined, the array is broken up into registers.
+				const Detail::LogArg encoded[] = { Detail::LogArg(std::get<TIndices>(args)) ..., Detail::LogArg(false) };
+				const size_t count = sizeof...(TIndices);
+				size_t size = RECORD_HEADER_LENGTH;
+				for (size_t i = 0; i < count; ++i)
+					size += encoded[i].EncodedLength();
+				size = (size + 7) & ~(size_t)7;
+
+				Detail::LogRing* ring;
+				auto pos = Begin(site, size, (uint32_t)count, ring);
+				if (pos == nullptr)
+					return;
+				for (size_t i = 0; i < count; ++i)
+					pos = encoded[i].Encode(pos);
+				ring->Commit(size);
+			}
+			void Calibrate();
+			size_t DrainAll(std::string& text, time_t& lastSecond, std::string& lastTime);
+			void Format(const Byte* record, std::string& text, time_t& lastSecond, std::string& lastTime);
+			void Work();
+		public:
+			AsyncLogger(IO::Stream& stream);
+			AsyncLogger(IO::Stream& stream, size_t ringCapacity, OverflowPolicy policy);
+			AsyncLogger(const AsyncLogger&) = delete;
+			AsyncLogger(AsyncLogger&&) = delete;
+			/*
+			 * Write out everything logged so far and stop. No thread may log to this logger any more.
+			 */
+			~AsyncLogger();
+
+			/*
+			 * Log $args, references as made by std::forward_as_tuple(), at $site.
+			 */
+			template<typename ... TArgs>
+			void Write(const LogSite& site, const std::tuple<TArgs ...>& args)
+			{
+				WriteArgs(site, args, std::index_sequence_for<TArgs ...>());
+			}
+			/*
+			 * Block until everything logged before the call is written to the stream and the stream is flushed.
+			 */
+			void Flush();
+			uint64_t DroppedCount() const;
+
+			static AsyncLogger* Default();
+			static void SetDefault(AsyncLogger* logger);
+			static const char* LevelName(LogLevel level);
+		};
+	}
+}
+
+#define _L_Log(level, format, ...) \
+	do \
+	{ \
+		if ((int)LiongPlus::Diagnostics::LogLevel::level >= _L_LOG_LEVEL) \
+		{ \
+			auto _L_Log_Logger = LiongPlus::Diagnostics::AsyncLogger::Default(); \
+			static const LiongPlus::Diagnostics::LogSite _L_Log_Site = { LiongPlus::Diagnostics::LogLevel::level, format, __FILE__, __LINE__ }; \
+			if (_L_Log_Logger != nullptr) \
+				_L_Log_Logger->Write(_L_Log_Site, std::forward_as_tuple(__VA_ARGS__)); \
+		} \
+	} while (false)
+#define _L_Log_Trace(format, ...) _L_Log(Trace, format, __VA_ARGS__)
+#define _L_Log_Debug(format, ...) _L_Log(Debug, format, __VA_ARGS__)
+#define _L_Log_Info(format, ...) _L_Log(Info, format, __VA_ARGS__)
+#define _L_Log_Warn(format, ...) _L_Log(Warn, format, __VA_ARGS__)
+#define _L_Log_Error(format, ...) _L_Log(Error, format, __VA_ARGS__)
+#endif
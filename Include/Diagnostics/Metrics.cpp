@@ -0,0 +1,218 @@
+// File: Metrics.cpp
+// Author: Rendong Liang (Liong)
+#include "Metrics.hpp"
+
+namespace LiongPlus
+{
+	namespace Diagnostics
+	{
+		namespace Detail
+		{
+			size_t MetricShardCount()
+			{
+				static const size_t count = []
+				{
+					size_t cores = std::max(std::thread::hardware_concurrency(), 1u), count = 1;
+					while (count < cores && count < 64)
+						count <<= 1;
+					return count;
+				}();
+				return count;
+			}
+
+			size_t AssignMetricShard()
+			{
+				static std::atomic<size_t> next(0);
+				return next.fetch_add(1, std::memory_order_relaxed) & (MetricShardCount() - 1);
+			}
+		}
+
+
+
+		Counter::Counter()
+			: _Cells(new Detail::MetricCell[Detail::MetricShardCount()])
+			, _Mask(Detail::MetricShardCount() - 1)
+		{
+			for (size_t i = 0; i <= _Mask; ++i)
+				_Cells[i].Value = 0;
+		}
+
+		int64_t Counter::Value() const
+		{
+			int64_t sum = 0;
+			for (size_t i = 0; i <= _Mask; ++i)
+				sum += _Cells[i].Value.load(std::memory_order_relaxed);
+			return sum;
+		}
+
+
+
+		Gauge::Gauge()
+			: _Value(0)
+		{
+		}
+
+		int64_t Gauge::Value() const
+		{
+			return _Value.load(std::memory_order_relaxed);
+		}
+
+
+
+		uint64_t HistogramSnapshot::Quantile(double quantile) const
+		{
+			if (Count == 0)
+				return 0;
+			auto rank = (uint64_t)std::ceil(std::min(std::max(quantile, 0.0), 1.0) * Count);
+			uint64_t seen = 0;
+			for (size_t i = 0; i < Counts.size(); ++i)
+			{
+				seen += Counts[i];
+				if (seen >= rank && seen != 0)
+					return Histogram::UpperBoundOf(i);
+			}
+			return Histogram::UpperBoundOf(Counts.size() - 1);
+		}
+
+
+
+		Histogram::Histogram()
+			: _Shards(new Shard[Detail::MetricShardCount()])
+			, _Mask(Detail::MetricShardCount() - 1)
+		{
+			for (size_t i = 0; i <= _Mask; ++i)
+			{
+				for (auto& count : _Shards[i].Counts)
+					count = 0;
+				_Shards[i].Sum = 0;
+			}
+		}
+
+		HistogramSnapshot Histogram::Snapshot() const
+		{
+			HistogramSnapshot snapshot;
+			snapshot.Counts.assign(BUCKET_COUNT, 0);
+			snapshot.Count = 0;
+			snapshot.Sum = 0;
+			for (size_t i = 0; i <= _Mask; ++i)
+			{
+				for (size_t j = 0; j < BUCKET_COUNT; ++j)
+				{
+					auto count = _Shards[i].Counts[j].load(std::memory_order_relaxed);
+					snapshot.Counts[j] += count;
+					snapshot.Count += count;
+				}
+				snapshot.Sum += _Shards[i].Sum.load(std::memory_order_relaxed);
+			}
+			return snapshot;
+		}
+
+		uint64_t Histogram::UpperBoundOf(size_t index)
+		{
+			if (index < SUB_BUCKET_COUNT)
+				return index;
+			size_t shift = index / SUB_BUCKET_COUNT - 1;
+			uint64_t lower = (uint64_t)(SUB_BUCKET_COUNT + index % SUB_BUCKET_COUNT) << shift;
+			return lower + (((uint64_t)1 << shift) - 1);
+		}
+
+
+
+		MetricsRegistry::MetricsRegistry()
+			: _Mutex()
+			, _Entries()
+		{
+		}
+
+		Counter& MetricsRegistry::GetCounter(const std::string& name, const std::string& help)
+		{
+			auto& entry = GetEntry(name, MetricType::Counter, help, 1);
+			return *entry.CounterPtr;
+		}
+		Gauge& MetricsRegistry::GetGauge(const std::string& name, const std::string& help)
+		{
+			auto& entry = GetEntry(name, MetricType::Gauge, help, 1);
+			return *entry.GaugePtr;
+		}
+		Histogram& MetricsRegistry::GetHistogram(const std::string& name, const std::string& help, double scale)
+		{
+			auto& entry = GetEntry(name, MetricType::Histogram, help, scale);
+			return *entry.HistogramPtr;
+		}
+
+		std::string MetricsRegistry::ToPrometheus() const
+		{
+			static const char* const QUANTILES[] = { "0.5", "0.9", "0.99", "0.999" };
+
+			std::stringstream text;
+			text << std::setprecision(17);
+			std::lock_guard<std::mutex> lock(_Mutex);
+			for (auto& pair : _Entries)
+			{
+				auto& name = pair.first;
+				auto& entry = pair.second;
+				if (!entry.Help.empty())
+					text << "# HELP " << name << ' ' << entry.Help << '\n';
+				switch (entry.Type)
+				{
+				case MetricType::Counter:
+					text << "# TYPE " << name << " counter\n" << name << ' ' << entry.CounterPtr->Value() << '\n';
+					break;
+				case MetricType::Gauge:
+					text << "# TYPE " << name << " gauge\n" << name << ' ' << entry.GaugePtr->Value() << '\n';
+					break;
+				case MetricType::Histogram:
+				{
+					// Quantiles are only meaningful per process, but the full bucket layout would be hundreds of series.
+					auto snapshot = entry.HistogramPtr->Snapshot();
+					text << "# TYPE " << name << " summary\n";
+					for (auto quantile : QUANTILES)
+						text << name << "{quantile=\"" << quantile << "\"} " << snapshot.Quantile(std::atof(quantile)) * entry.Scale << '\n';
+					text << name << "_sum " << snapshot.Sum * entry.Scale << '\n'
+						<< name << "_count " << snapshot.Count << '\n';
+					break;
+				}
+				}
+			}
+			return text.str();
+		}
+
+		MetricsRegistry& MetricsRegistry::Default()
+		{
+			static MetricsRegistry registry;
+			return registry;
+		}
+
+		// Private
+
+		MetricsRegistry::Entry& MetricsRegistry::GetEntry(const std::string& name, MetricType type, const std::string& help, double scale)
+		{
+			std::lock_guard<std::mutex> lock(_Mutex);
+			auto it = _Entries.find(name);
+			if (it != _Entries.end())
+			{
+				if (it->second.Type != type)
+					throw std::runtime_error("$name is taken by a metric of another type.");
+				return it->second;
+			}
+
+			auto& entry = _Entries[name];
+			entry.Type = type;
+			entry.Help = help;
+			entry.Scale = scale;
+			switch (type)
+			{
+			case MetricType::Counter:
+				entry.CounterPtr.reset(new Counter());
+				break;
+			case MetricType::Gauge:
+				entry.GaugePtr.reset(new Gauge());
+				break;
+			case MetricType::Histogram:
+				entry.HistogramPtr.reset(new Histogram());
+				break;
+			}
+			return entry;
+		}
+	}
+}
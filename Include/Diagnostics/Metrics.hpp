@@ -0,0 +1,199 @@
+// File: Metrics.hpp
+// Author: Rendong Liang (Liong)
+
+#ifndef _L_Metrics
+#define _L_Metrics
+#include "../Fundamental.hpp"
+
+namespace LiongPlus
+{
+	namespace Diagnostics
+	{
+		namespace Detail
+		{
+			// Updates from different threads land on different cache lines.
+			struct alignas(64) MetricCell
+			{
+				std::atomic<int64_t> Value;
+			};
+
+			/*
+			 * Number of shards of each metric, a power of two no less than the number of cores.
+			 */
+			size_t MetricShardCount();
+			size_t AssignMetricShard();
+
+			/*
+			 * Threads are spread round-robin over the shards and stay on theirs, so a thread never shares a cache line with another one unless there are more threads than shards.
+			 */
+			inline size_t MetricShard()
+			{
+				static thread_local size_t shard = SIZE_MAX;
+				if (shard == SIZE_MAX)
+					shard = AssignMetricShard();
+				return shard;
+			}
+		}
+
+		/*
+		 * A monotonically increasing count, sharded so that hot paths on different threads never contend.
+		 */
+		class Counter
+		{
+		private:
+			std::unique_ptr<Detail::MetricCell[]> _Cells;
+			size_t _Mask;
+		public:
+			Counter();
+			Counter(const Counter&) = delete;
+			Counter(Counter&&) = delete;
+
+			inline void Add(int64_t value = 1)
+			{
+				_Cells[Detail::MetricShard() & _Mask].Value.fetch_add(value, std::memory_order_relaxed);
+			}
+			/*
+			 * [return] Sum over the shards. Concurrent updates may or may not be included.
+			 */
+			int64_t Value() const;
+		};
+
+		/*
+		 * A value that goes up and down. Not sharded, since a Set() has to win over every earlier Add().
+		 */
+		class Gauge
+		{
+		private:
+			std::atomic<int64_t> _Value;
+		public:
+			Gauge();
+			Gauge(const Gauge&) = delete;
+			Gauge(Gauge&&) = delete;
+
+			inline void Set(int64_t value)
+			{
+				_Value.store(value, std::memory_order_relaxed);
+			}
+			inline void Add(int64_t value)
+			{
+				_Value.fetch_add(value, std::memory_order_relaxed);
+			}
+			int64_t Value() const;
+		};
+
+		/*
+		 * Bucket counts of a histogram merged over its shards.
+		 */
+		struct HistogramSnapshot
+		{
+			std::vector<uint64_t> Counts;
+			uint64_t Count;
+			uint64_t Sum;
+
+			/*
+			 * [return] The highest value equivalent to the $quantile-th recorded value, 0 if nothing is recorded.
+			 */
+			uint64_t Quantile(double quantile) const;
+		};
+
+		/*
+		 * A histogram of non-negative integers, e.g. latencies in nanoseconds, in HDR-style log-linear buckets: each power of two is split into SUB_BUCKET_COUNT buckets, so any value is kept within 1/SUB_BUCKET_COUNT of itself at a fixed memory cost.
+		 */
+		class Histogram
+		{
+		public:
+			static const size_t SUB_BUCKET_BITS = 3;
+			static const size_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+			static const size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+		private:
+			struct alignas(64) Shard
+			{
+				std::atomic<uint64_t> Counts[BUCKET_COUNT];
+				std::atomic<uint64_t> Sum;
+			};
+
+			std::unique_ptr<Shard[]> _Shards;
+			size_t _Mask;
+		public:
+			Histogram();
+			Histogram(const Histogram&) = delete;
+			Histogram(Histogram&&) = delete;
+
+			inline void Record(uint64_t value)
+			{
+				auto& shard = _Shards[Detail::MetricShard() & _Mask];
+				shard.Counts[BucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+				shard.Sum.fetch_add(value, std::memory_order_relaxed);
+			}
+			HistogramSnapshot Snapshot() const;
+
+			static inline size_t BucketOf(uint64_t value)
+			{
+				// Values below SUB_BUCKET_COUNT are exact; above, the exponent picks a row and the next bits a column.
+				if (value < SUB_BUCKET_COUNT)
+					return (size_t)value;
+#ifdef _L_MSVC
+				unsigned long exponent;
+				_BitScanReverse64(&exponent, value);
+#else
+				size_t exponent = 63 - __builtin_clzll(value);
+#endif
+				size_t shift = exponent - SUB_BUCKET_BITS;
+				return (shift + 1) * SUB_BUCKET_COUNT + (size_t)((value >> shift) & (SUB_BUCKET_COUNT - 1));
+			}
+			/*
+			 * [return] The highest value that falls into bucket $index.
+			 */
+			static uint64_t UpperBoundOf(size_t index);
+		};
+
+		/*
+		 * Named metrics, exported in the Prometheus text format. Metrics live as long as the registry, so hot paths look them up once and keep the reference.
+		 */
+		class MetricsRegistry
+		{
+		private:
+			enum class MetricType
+			{
+				Counter,
+				Gauge,
+				Histogram
+			};
+			struct Entry
+			{
+				MetricType Type;
+				std::string Help;
+				// Histograms are exported multiplied by this, e.g. to turn nanoseconds into seconds.
+				double Scale;
+				std::unique_ptr<Counter> CounterPtr;
+				std::unique_ptr<Gauge> GaugePtr;
+				std::unique_ptr<Histogram> HistogramPtr;
+			};
+
+			mutable std::mutex _Mutex;
+			std::map<std::string, Entry> _Entries;
+
+			Entry& GetEntry(const std::string& name, MetricType type, const std::string& help, double scale);
+		public:
+			MetricsRegistry();
+			MetricsRegistry(const MetricsRegistry&) = delete;
+			MetricsRegistry(MetricsRegistry&&) = delete;
+
+			/*
+			 * Get the metric named $name, creating it at the first call.
+			 * [note] Throws if $name is taken by a metric of another type.
+			 */
+			Counter& GetCounter(const std::string& name, const std::string& help);
+			Gauge& GetGauge(const std::string& name, const std::string& help);
+			Histogram& GetHistogram(const std::string& name, const std::string& help, double scale = 1);
+
+			/*
+			 * [return] All metrics in the Prometheus text exposition format. Histograms are exported as summaries with their 0.5, 0.9, 0.99 and 0.999 quantiles.
+			 */
+			std::string ToPrometheus() const;
+
+			static MetricsRegistry& Default();
+		};
+	}
+}
+#endif
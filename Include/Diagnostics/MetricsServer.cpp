@@ -0,0 +1,60 @@
+// File: MetricsServer.cpp
+// Author: Rendong Liang (Liong)
+#include "MetricsServer.hpp"
+#include "../Net/HttpMessage.hpp"
+
+#ifdef _L_COROUTINE
+namespace LiongPlus
+{
+	namespace Diagnostics
+	{
+		using namespace LiongPlus::Net;
+
+		// Scrapes are small; a larger request head is not from a scraper.
+		static const size_t MAX_REQUEST_LENGTH = 8192;
+
+		MetricsServer::MetricsServer(const SocketAddress& addr)
+			: MetricsServer(addr, MetricsRegistry::Default())
+		{
+		}
+		MetricsServer::MetricsServer(const SocketAddress& addr, MetricsRegistry& registry)
+			: _Registry(registry)
+			, _Server(addr, 1, 16, [&registry](EventLoop& loop, Socket socket, const SocketAddress&)
+			{
+				Spawn(loop, Serve(registry, std::move(socket)));
+			})
+		{
+		}
+
+		// Private
+
+		Task<void> MetricsServer::Serve(MetricsRegistry& registry, Socket socket)
+		{
+			std::string request;
+			Buffer buffer(1024);
+			while (request.find("\r\n\r\n") == std::string::npos && request.find("\n\n") == std::string::npos)
+			{
+				auto received = co_await ReceiveAsync(socket, buffer);
+				if (received == 0 || request.size() + received > MAX_REQUEST_LENGTH)
+					co_return;
+				request.append(buffer.Field(), received);
+			}
+
+			bool isFound = request.compare(0, 13, "GET /metrics ") == 0 || request.compare(0, 13, "GET /metrics?") == 0;
+			auto text = isFound ? registry.ToPrometheus() : std::string("Not Found\n");
+			Buffer content(text.size());
+			memcpy(content.Field(), text.data(), text.size());
+
+			HttpStatusLine line(1, 1, isFound ? 200 : 404, isFound ? "OK" : "Not Found");
+			HttpHeader header;
+			std::string contentType = HttpHeader::Entity::ContentType, contentLength = HttpHeader::Entity::ContentLength, connection = HttpHeader::General::Connection;
+			header[contentType] = isFound ? "text/plain; version=0.0.4; charset=utf-8" : "text/plain";
+			header[contentLength] = std::to_string(text.size());
+			header[connection] = "close";
+			HttpResponse response(header, line, SharedBuffer(std::move(content)));
+			auto data = response.ToBuffer();
+			co_await SendAsync(socket, data);
+		}
+	}
+}
+#endif // _L_COROUTINE
@@ -0,0 +1,38 @@
+// File: MetricsServer.hpp
+// Author: Rendong Liang (Liong)
+
+#ifndef _L_MetricsServer
+#define _L_MetricsServer
+#include "../Fundamental.hpp"
+#include "../Net/Async.hpp"
+#include "../Net/TcpServer.hpp"
+#include "Metrics.hpp"
+
+#ifdef _L_COROUTINE
+namespace LiongPlus
+{
+	namespace Diagnostics
+	{
+		/*
+		 * Serves a metrics registry to Prometheus scrapers over HTTP: GET /metrics answers with the text exposition format, anything else with 404. Each connection serves one request and is closed.
+		 */
+		class MetricsServer
+		{
+		private:
+			MetricsRegistry& _Registry;
+			Net::TcpServer _Server;
+
+			static Net::Task<void> Serve(MetricsRegistry& registry, Net::Socket socket);
+		public:
+			/*
+			 * Listen on $addr, usually a loopback address, with a single loop thread.
+			 */
+			MetricsServer(const Net::SocketAddress& addr);
+			MetricsServer(const Net::SocketAddress& addr, MetricsRegistry& registry);
+			MetricsServer(const MetricsServer&) = delete;
+			MetricsServer(MetricsServer&&) = delete;
+		};
+	}
+}
+#endif // _L_COROUTINE
+#endif
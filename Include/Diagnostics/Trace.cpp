@@ -0,0 +1,175 @@
+// File: Trace.cpp
+// Author: Rendong Liang (Liong)
+#include "Trace.hpp"
+
+namespace LiongPlus
+{
+	namespace Diagnostics
+	{
+		using namespace std::chrono;
+
+		struct Tracer::ThreadBuffer
+		{
+			// Only contended while events are exported or cleared.
+			std::mutex Mutex;
+			std::vector<Event> Events;
+			uint64_t ThreadId;
+			std::string ThreadName;
+			std::atomic<bool> IsOrphaned;
+		};
+
+		std::atomic<bool> Tracer::_IsEnabled(false);
+		std::mutex Tracer::_Mutex;
+		std::vector<std::shared_ptr<Tracer::ThreadBuffer>> Tracer::_Buffers;
+
+		static const steady_clock::time_point _Epoch = steady_clock::now();
+		static uint64_t _NextThreadId = 1;
+		static std::atomic<uint64_t> _DroppedCount(0);
+
+		static void AppendJsonString(std::string& json, const char* str)
+		{
+			json += '"';
+			for (; *str != '\0'; ++str)
+			{
+				if (*str == '"' || *str == '\\')
+					json += '\\';
+				if ((unsigned char)*str >= 0x20)
+					json += *str;
+			}
+			json += '"';
+		}
+
+		void Tracer::Start()
+		{
+			_IsEnabled.store(true, std::memory_order_relaxed);
+		}
+		void Tracer::Stop()
+		{
+			_IsEnabled.store(false, std::memory_order_relaxed);
+		}
+
+		void Tracer::SetThreadName(std::string name)
+		{
+			auto& buffer = GetBuffer();
+			std::lock_guard<std::mutex> lock(buffer.Mutex);
+			buffer.ThreadName = std::move(name);
+		}
+
+		void Tracer::Clear()
+		{
+			std::lock_guard<std::mutex> lock(_Mutex);
+			for (auto& buffer : _Buffers)
+			{
+				std::lock_guard<std::mutex> bufferLock(buffer->Mutex);
+				buffer->Events.clear();
+			}
+			// Buffers of threads that have exited are never written again.
+			_Buffers.erase(std::remove_if(_Buffers.begin(), _Buffers.end(), [](const std::shared_ptr<ThreadBuffer>& buffer)
+			{
+				return buffer->IsOrphaned.load();
+			}), _Buffers.end());
+			_DroppedCount = 0;
+		}
+
+		uint64_t Tracer::DroppedCount()
+		{
+			return _DroppedCount.load(std::memory_order_relaxed);
+		}
+
+		int64_t Tracer::Now()
+		{
+			return duration_cast<nanoseconds>(steady_clock::now() - _Epoch).count();
+		}
+
+		void Tracer::Record(const char* category, const char* name, int64_t start, int64_t end)
+		{
+			auto& buffer = GetBuffer();
+			std::lock_guard<std::mutex> lock(buffer.Mutex);
+			if (buffer.Events.size() >= MAX_EVENTS_PER_THREAD)
+			{
+				_DroppedCount.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			buffer.Events.push_back(Event{ category, name, start, end - start });
+		}
+
+		std::string Tracer::ToJson()
+		{
+#ifdef _L_WINDOWS
+			auto pid = std::to_string(GetCurrentProcessId());
+#else
+			auto pid = std::to_string(getpid());
+#endif
+			std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+			bool isFirst = true;
+			char buffer[96];
+
+			std::lock_guard<std::mutex> lock(_Mutex);
+			for (auto& threadBuffer : _Buffers)
+			{
+				std::lock_guard<std::mutex> bufferLock(threadBuffer->Mutex);
+				auto tid = std::to_string(threadBuffer->ThreadId);
+				if (!threadBuffer->ThreadName.empty())
+				{
+					json += isFirst ? "\n" : ",\n";
+					isFirst = false;
+					json += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" + pid + ",\"tid\":" + tid + ",\"args\":{\"name\":";
+					AppendJsonString(json, threadBuffer->ThreadName.c_str());
+					json += "}}";
+				}
+				for (auto& event : threadBuffer->Events)
+				{
+					json += isFirst ? "\n" : ",\n";
+					isFirst = false;
+					json += "{\"ph\":\"X\",\"cat\":";
+					AppendJsonString(json, event.Category);
+					json += ",\"name\":";
+					AppendJsonString(json, event.Name);
+					// Chrome expects microseconds.
+					snprintf(buffer, sizeof(buffer), ",\"ts\":%.3f,\"dur\":%.3f", event.Start / 1e3, event.Duration / 1e3);
+					json += buffer;
+					json += ",\"pid\":" + pid + ",\"tid\":" + tid + "}";
+				}
+			}
+			json += "\n]}\n";
+			return json;
+		}
+
+		void Tracer::Save(const std::string& path)
+		{
+			auto json = ToJson();
+			std::ofstream file(path, std::ios::binary);
+			if (!file)
+				throw std::runtime_error("Failed in opening $path for trace output.");
+			file.write(json.data(), json.size());
+		}
+
+		// Private
+
+		Tracer::ThreadBuffer& Tracer::GetBuffer()
+		{
+			struct BufferCache
+			{
+				std::shared_ptr<ThreadBuffer> Buffer;
+
+				~BufferCache()
+				{
+					// Events stay for export after the thread exits.
+					if (Buffer)
+						Buffer->IsOrphaned = true;
+				}
+			};
+			static thread_local BufferCache cache;
+
+			if (!cache.Buffer)
+			{
+				cache.Buffer = std::make_shared<ThreadBuffer>();
+				cache.Buffer->IsOrphaned = false;
+				std::lock_guard<std::mutex> lock(_Mutex);
+				cache.Buffer->ThreadId = _NextThreadId++;
+				_Buffers.push_back(cache.Buffer);
+			}
+			return *cache.Buffer;
+		}
+	}
+}
@@ -0,0 +1,110 @@
+// File: Trace.hpp
+// Author: Rendong Liang (Liong)
+
+#ifndef _L_Trace
+#define _L_Trace
+#include "../Fundamental.hpp"
+
+namespace LiongPlus
+{
+	namespace Diagnostics
+	{
+		/*
+		 * Collects timed spans in per-thread buffers and exports them in the Chrome trace event format, which chrome://tracing and Perfetto open.
+		 * Tracing is off until Start() is called. Spans are made with the _L_Trace_Span macro, which costs a single branch while tracing is off and nothing at all in release builds.
+		 */
+		class Tracer
+		{
+		public:
+			struct Event
+			{
+				const char* Category;
+				const char* Name;
+				// Nanoseconds since the tracer was loaded.
+				int64_t Start, Duration;
+			};
+		private:
+			struct ThreadBuffer;
+
+			static std::atomic<bool> _IsEnabled;
+			static std::mutex _Mutex;
+			static std::vector<std::shared_ptr<ThreadBuffer>> _Buffers;
+
+			static ThreadBuffer& GetBuffer();
+		public:
+			// Events a thread keeps before it drops new ones, to bound memory in long sessions.
+			static const size_t MAX_EVENTS_PER_THREAD = 1 << 20;
+
+			static void Start();
+			static void Stop();
+			static inline bool IsEnabled()
+			{
+				return _IsEnabled.load(std::memory_order_relaxed);
+			}
+
+			/*
+			 * Name the calling thread in exported traces.
+			 */
+			static void SetThreadName(std::string name);
+			/*
+			 * Discard all recorded events.
+			 */
+			static void Clear();
+			static uint64_t DroppedCount();
+
+			static int64_t Now();
+			static void Record(const char* category, const char* name, int64_t start, int64_t end);
+
+			/*
+			 * [return] Recorded events in the JSON object format of Chrome trace events.
+			 */
+			static std::string ToJson();
+			/*
+			 * Write ToJson() to the file at $path.
+			 */
+			static void Save(const std::string& path);
+		};
+
+		/*
+		 * Records the time from its construction to its destruction as a span, if tracing was on when it was constructed.
+		 * $category and $name must outlive the tracer, e.g. string literals.
+		 */
+		class TraceSpan
+		{
+		private:
+			const char* _Category;
+			const char* _Name;
+			int64_t _Start;
+		public:
+			inline TraceSpan(const char* category, const char* name)
+				: _Category(category)
+				, _Name(nullptr)
+				, _Start(0)
+			{
+				if (Tracer::IsEnabled())
+				{
+					_Name = name;
+					_Start = Tracer::Now();
+				}
+			}
+			TraceSpan(const TraceSpan&) = delete;
+			TraceSpan(TraceSpan&&) = delete;
+			inline ~TraceSpan()
+			{
+				if (_Name != nullptr)
+					Tracer::Record(_Category, _Name, _Start, Tracer::Now());
+			}
+		};
+	}
+}
+
+#define _L_Trace_Concat_(a, b) a##b
+#define _L_Trace_Concat(a, b) _L_Trace_Concat_(a, b)
+// Release builds drop spans entirely.
+#ifdef _L_RELEASE
+#define _L_Trace_Span(category, name) ((void)0)
+#else
+#define _L_Trace_Span(category, name) LiongPlus::Diagnostics::TraceSpan _L_Trace_Concat(_L_Trace_Span_, __LINE__)(category, name)
+#endif
+#define _L_Trace_Function(category) _L_Trace_Span(category, __FUNCTION__)
+#endif
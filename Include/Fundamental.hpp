@@ -76,34 +76,66 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <netdb.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <poll.h>
+#include <cerrno>
+
+#ifdef _L_LINUX
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <pthread.h>
+#include <sched.h>
+#endif // _L_LINUX
+
 #endif // !_L_WINDOWS
 
 #ifndef _L_DEBUG
 #define NDEBUG
 #endif
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <cwchar>
 #include <cassert>
 #include <codecvt>
+#include <deque>
 #include <exception>
+#include <fstream>
 #include <functional>
 #include <future>
 #include <set>
 #include <initializer_list>
+#include <iomanip>
+#include <iostream>
+#include <list>
 #include <locale>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <new>
 #include <regex>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <sstream>
+#include <system_error>
 #include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #ifdef _L_MSVC
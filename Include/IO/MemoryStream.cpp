@@ -1,6 +1,7 @@
 // File: MemoryStream.cpp
 // Author: Rendong Liang (Liong)
 #include "MemoryStream.hpp"
+#include "../Memory/LargePageResource.hpp"
 
 namespace LiongPlus
 {
@@ -8,7 +9,7 @@ namespace LiongPlus
 	{
 		using std::swap;
 		MemoryStream::MemoryStream()
-			: _Buffer(DEFAULT_BUFFER_CHUNK_SIZE)
+			: _Buffer(DEFAULT_BUFFER_CHUNK_SIZE, Memory::LargePageResource::Shared())
 			, _Position(0)
 			, _Permission(StreamAccessPermission::ReadWrite)
 			, _IsClosed(false)
@@ -26,7 +27,7 @@ namespace LiongPlus
 			swap(_IsClosed, instance._IsClosed);
 		}
 		MemoryStream::MemoryStream(StreamAccessPermission permission)
-			: _Buffer(DEFAULT_BUFFER_CHUNK_SIZE)
+			: _Buffer(DEFAULT_BUFFER_CHUNK_SIZE, Memory::LargePageResource::Shared())
 			, _Position(0)
 			, _Permission(permission)
 			, _IsClosed(false)
@@ -56,7 +57,7 @@ namespace LiongPlus
 
 		Buffer MemoryStream::ToBuffer()
 		{
-			Buffer rv(_Buffer.Length());
+			Buffer rv(_Buffer.Length(), Memory::LargePageResource::Shared());
 			memcpy(rv.Field(), _Buffer.Field(), _Buffer.Length());
 			return rv;
 		}
@@ -120,7 +121,7 @@ namespace LiongPlus
 		{
 			assert(CanRead(), "Cannot read from this instance");
 
-			Buffer buffer = Buffer(length);
+			Buffer buffer = Buffer(length, Memory::LargePageResource::Shared());
 			Read(buffer.Field(), length);
 			return buffer;
 		}
@@ -167,12 +168,8 @@ namespace LiongPlus
 
 		bool MemoryStream::SetCapacity(size_t capacity)
 		{
-			if (capacity != _Buffer.Length()) // Need to reallocate.
-			{
-				Buffer newBuffer(capacity);
-				memcpy(newBuffer.Field(), _Buffer.Field(), capacity > _Buffer.Length() ? _Buffer.Length() : capacity);
-				_Buffer = std::move(newBuffer);
-			}
+			// In place where possible, e.g. by remapping large streams.
+			_Buffer.Resize(capacity);
 
 			return true;
 		}
@@ -8,13 +8,67 @@
 
 namespace LiongPlus
 {
+	/*
+	 * Keeps an observer subscribed until it is disposed or destroyed.
+	 */
+	class Subscription
+	{
+	private:
+		Action<> _Unsubscribe;
+	public:
+		Subscription()
+			: _Unsubscribe()
+		{
+		}
+		Subscription(Action<> unsubscribe)
+			: _Unsubscribe(std::move(unsubscribe))
+		{
+		}
+		Subscription(const Subscription&) = delete;
+		Subscription(Subscription&& instance)
+			: _Unsubscribe(std::move(instance._Unsubscribe))
+		{
+			instance._Unsubscribe = nullptr;
+		}
+		~Subscription()
+		{
+			Dispose();
+		}
+
+		Subscription& operator=(const Subscription&) = delete;
+		Subscription& operator=(Subscription&& instance)
+		{
+			using std::swap;
+			Dispose();
+			swap(_Unsubscribe, instance._Unsubscribe);
+			return *this;
+		}
+
+		void Dispose()
+		{
+			if (_Unsubscribe)
+			{
+				auto unsubscribe = std::move(_Unsubscribe);
+				_Unsubscribe = nullptr;
+				unsubscribe();
+			}
+		}
+		bool IsActive() const
+		{
+			return (bool)_Unsubscribe;
+		}
+	};
+
 	template<typename T>
 	class IObservable
-		: public virtual Interface
 	{
 	public:
-		virtual unique_ptr<Object> Subscribe(IObserver<T> observer) = 0;
-	}
+		using TValue = T;
+
+		virtual ~IObservable() {}
+
+		virtual Subscription Subscribe(std::shared_ptr<IObserver<T>> observer) = 0;
+	};
 }
 
 #endif
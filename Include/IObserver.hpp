@@ -4,18 +4,26 @@
 #ifndef _L_IObserver
 #define _L_IObserver
 #include "Fundamental.hpp"
-#include "Exception.hpp"
 
 namespace LiongPlus
 {
 	template<typename T>
 	class IObserver
-		: public virtual Interface
 	{
 	public:
+		virtual ~IObserver() {}
+
 		virtual void OnCompleted() = 0;
-		virtual void OnError(Exception e) = 0;
-		virtual void OnNext(T value) = 0;		
-	}
+		virtual void OnError(std::exception_ptr e) = 0;
+		virtual void OnNext(const T& value) = 0;
+		/*
+		 * Receive $count values at once. Observers on hot paths should override this so that a whole batch costs a single virtual call.
+		 */
+		virtual void OnNextBatch(const T* values, size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+				OnNext(values[i]);
+		}
+	};
 }
 #endif
@@ -9,9 +9,10 @@ namespace LiongPlus
 {   
     template<typename T>
     class IProgress
-        : public Interface
     {
     public:
+        virtual ~IProgress() {}
+
         virtual void Report(T value) = 0;
     };
 }
@@ -4,222 +4,172 @@
 #ifndef _L_Lazy
 #define _L_Lazy
 #include "Fundamental.hpp"
-#include <mutex>
-#include <thread>
 
 namespace LiongPlus
 {
 	enum class LazyThreadSafetyMode
 	{
+		/// <summary>
+		/// Only one thread runs the initializer; the others wait for its value.
+		/// </summary>
 		ExecutionAndPublication,
+		/// <summary>
+		/// No synchronization at all. The Lazy object must not be shared between threads before the value is created.
+		/// </summary>
 		None,
+		/// <summary>
+		/// Racing threads may all run the initializer. The first value finished is published and the others are discarded.
+		/// </summary>
 		PublicationOnly
 	};
 
+	/// <summary>
+	/// A value created on first use and stored inline.
+	/// Once the value exists, GetValue() costs a single acquire load regardless of the thread safety mode.
+	/// If the initializer throws, nothing is published and the next GetValue() runs it again.
+	/// </summary>
 	template<typename T>
 	class Lazy
 	{
 	private:
-		using TInitializer = Func<T*(void)>;
-
-		class LazyObjectCaller
+		enum State
 		{
-		public:
-			LazyObjectCaller(TInitializer& initializer)
-				: _Initializer(new TInitializer(initializer))
-				: _Value(nullptr)
-			{
-			}
-			virtual ~LazyThreadSafeCaller()
-			{
-				if (_Initializer != nullptr)
-				{
-					delete _Initializer;
-					_Initializer = nullptr;
-				}
-			}
-
-			bool IsValueCreated()
-			{
-				return _Value != nullptr;
-			}
-			virtual T& GetValue() = 0;
-		private:
-			TInitializer* _Initializer;
-			Ptr<T> _Value;
+			Uninitialized,
+			Publishing,
+			Created
 		};
 
-		class LazyThreadUnsafeCaller
-			: public LazyObjectCaller
-		{
-		public:
-			LazyThreadUnsafeCaller(TInitializer& initializer)
-				: LazyObjectCaller(initializer)
-			{
-			}
-			virtual ~LazyThreadUnsafeCaller()
-			{
-			}
+		Func<T> _Initializer;
+		LazyThreadSafetyMode _Mode;
+		std::atomic<int> _State;
+		std::mutex _Mutex;
+		alignas(T) Byte _Storage[sizeof(T)];
 
-			virtual T& GetValue() override final
-			{
-				if (_Value == nullptr)
-				{
-					_Value = (*_Initializer)();
-					delete _Initializer;
-					_Initializer = nullptr;
-				}
+		T& Value()
+		{
+			return *reinterpret_cast<T*>(_Storage);
+		}
 
-				return *_Value;
-			}
-		};
-		
-		class LazyThreadSafeSharedCaller
-			: public LazyObjectCaller
+		T& Create()
 		{
-		public:
-			LazyThreadSafeSharedCaller(TInitializer& initializer)
-				: LazyObjectCaller(initializer)
+			switch (_Mode)
 			{
-			}
-			virtual ~LazyThreadSafeSharedCaller()
-			{
-			}
-
-			virtual T& GetValue() override final
+			case LazyThreadSafetyMode::None:
+				new (_Storage) T(_Initializer());
+				_Initializer = nullptr;
+				_State.store(Created, std::memory_order_release);
+				break;
+			case LazyThreadSafetyMode::ExecutionAndPublication:
 			{
-				_Mutex.lock();
-				if (_Value == nullptr)
+				std::lock_guard<std::mutex> lock(_Mutex);
+				// Someone else might have created the value while we were waiting for the lock.
+				if (_State.load(std::memory_order_relaxed) != Created)
 				{
-					_Value = (*_Initializer)();
-					delete _Initializer;
+					new (_Storage) T(_Initializer());
 					_Initializer = nullptr;
+					_State.store(Created, std::memory_order_release);
 				}
-				_Mutex.unlock();
-
-				return *_Value;
+				break;
 			}
-		private:
-			std::mutex _Mutex;
-		};
-		
-		class LazyThreadSafeOccupiedCaller
-			: public LazyObjectCaller
-		{
-		public:
-			LazyThreadSafeOccupiedCaller(TInitializer& initializer)
-				: LazyObjectCaller(initializer)
-				: _ThreadId(0)
+			case LazyThreadSafetyMode::PublicationOnly:
 			{
-			}
-			virtual ~LazyThreadSafeOccupiedCaller()
-			{
-				_ThreadId = 0;
-			}
-
-			virtual T& GetValue() override final
-			{
-				_Mutex.lock();
-				if (_ThreadId == 0)
-				{
-					auto tid = std::this_thread::get_id();
-					_ThreadId = *((unsigned long*)(&tid));
-				}
-				if (this_thread::get_id() == _ThreadId)
+				T value = _Initializer();
+				while (true)
 				{
-					if (_Value == nullptr)
+					int expected = Uninitialized;
+					if (_State.compare_exchange_strong(expected, Publishing, std::memory_order_acq_rel))
 					{
-						_Value = (*_Initializer)();
-						delete _Initializer;
-						_Initializer = nullptr;
+						try
+						{
+							new (_Storage) T(std::move(value));
+						}
+						catch (...)
+						{
+							// Nothing was published, so let the others try theirs.
+							_State.store(Uninitialized, std::memory_order_release);
+							throw;
+						}
+						// Other threads may still be running the initializer, so it is kept.
+						_State.store(Created, std::memory_order_release);
+						break;
 					}
+					// Lost the race. The winner is only moving its value in, so this wait is short. If that move throws, try again with our own value.
+					while (expected == Publishing)
+					{
+						std::this_thread::yield();
+						expected = _State.load(std::memory_order_acquire);
+					}
+					if (expected == Created)
+						break;
 				}
-				else throw InvalidOperationException("Current thread failed to fetch the permission from the lazy object.");
-				_Mutex.unlock();
-
-				return *_Value;
+				break;
 			}
-		private:
-			unsigned long _ThreadId;
-			std::mutex _Mutex;
-		};
-		
+			}
+			return Value();
+		}
 	public:
 		Lazy()
-			: _Value(new LazyThreadSafeSharedCaller(new Func<T*(void)>([] { return new T; })))
+			: Lazy([] { return T(); }, LazyThreadSafetyMode::ExecutionAndPublication)
 		{
 		}
-		Lazy(const Lazy<T>& instance) = delete;
-		Lazy(Lazy<T>&& instance)
-			: _Value(nullptr)
+		Lazy(LazyThreadSafetyMode mode)
+			: Lazy([] { return T(); }, mode)
 		{
-			swap(_Value, instance._Value);
 		}
-		Lazy(LazyThreadSafetyMode mode)
+		Lazy(Func<T> initializer)
+			: Lazy(initializer, LazyThreadSafetyMode::ExecutionAndPublication)
 		{
-			switch (mode)
-			{
-				case LazyThreadSafetyMode::ExecutionAndPublication:
-					_Value(new LazyThreadSafeSharedCaller(new Func<T*(void)>([] { return new T; })));
-					break;
-				case LazyThreadSafetyMode::None:
-					_Value(new LazyThreadUnsafeCaller(new Func<T*(void)>([] { return new T; })));
-					break;
-				case LazyThreadSafetyMode::PublicationOnly:
-					_Value(new LazyThreadSafeOccupiedCaller(new Func<T*(void)>([] { return new T; })));
-					break;
-				default:
-					throw std::runtime_error("Invalid $mode.");
-			}
 		}
-		Lazy(Func<T>& initializer)
-			: _Value(new LazyThreadSafeSharedCaller(initializer))
+		Lazy(Func<T> initializer, LazyThreadSafetyMode mode)
+			: _Initializer(std::move(initializer))
+			, _Mode(mode)
+			, _State(Uninitialized)
+			, _Mutex()
 		{
+			if (mode != LazyThreadSafetyMode::ExecutionAndPublication &&
+				mode != LazyThreadSafetyMode::None &&
+				mode != LazyThreadSafetyMode::PublicationOnly)
+				throw std::runtime_error("Invalid $mode.");
 		}
-		Lazy(Func<T>& initializer, LazyThreadSafetyMode mode)
+		Lazy(const Lazy<T>& instance) = delete;
+		/// <note>Moving is not synchronized. Do not move a Lazy object that other threads are using.</note>
+		Lazy(Lazy<T>&& instance)
+			: _Initializer(std::move(instance._Initializer))
+			, _Mode(instance._Mode)
+			, _State(Uninitialized)
+			, _Mutex()
 		{
-			switch (mode)
+			if (instance._State.load(std::memory_order_acquire) == Created)
 			{
-				case LazyThreadSafetyMode::ExecutionAndPublication:
-					_Value(new LazyThreadSafeSharedCaller(initializer));
-					break;
-				case LazyThreadSafetyMode::None:
-					_Value(new LazyThreadUnsafeCaller(initializer));
-					break;
-				case LazyThreadSafetyMode::PublicationOnly:
-					_Value(new LazyThreadSafeOccupiedCaller(initializer));
-					break;
-				default:
-					throw std::runtime_error("Invalid $mode.");
+				new (_Storage) T(std::move(instance.Value()));
+				_State.store(Created, std::memory_order_relaxed);
 			}
 		}
 		~Lazy()
 		{
-			if (_Value != nullptr)
-			{
-				delete _Value;
-				_Value = nullptr;
-			}
+			if (_State.load(std::memory_order_acquire) == Created)
+				Value().~T();
 		}
-		
+
 		Lazy<T>& operator=(const Lazy<T>& instance) = delete;
-		Lazy<T>& operator=(Lazy<T>&& instance)
+		Lazy<T>& operator=(Lazy<T>&& instance) = delete;
+
+		T& GetValue()
 		{
-			swap(_Value, instance._Value);
+			if (_State.load(std::memory_order_acquire) == Created)
+				return Value();
+			return Create();
 		}
-		
-		T& GetValue()
+
+		bool IsValueCreated() const
 		{
-			return _Value->GetValue();
+			return _State.load(std::memory_order_acquire) == Created;
 		}
-		
-		bool IsValueCreated()
+
+		LazyThreadSafetyMode Mode() const
 		{
-			return _Value->IsValueCreated();
+			return _Mode;
 		}
-		
-	private:
-		unique_ptr<LazyObjectCaller> _Value;
 	};
 }
 #endif
@@ -2,6 +2,8 @@
 // Author: Rendong Liang (Liong)
 
 #include "Bitmap.hpp"
+#include "../Diagnostics/Trace.hpp"
+#include "../Memory/LargePageResource.hpp"
 
 namespace LiongPlus
 {
@@ -17,7 +19,7 @@ namespace LiongPlus
 		{
 		}
 		Bitmap::Bitmap(const Bitmap& instance)
-			: _Buffer()
+			: _Buffer(instance._Buffer)
 			, _PixelType(instance._PixelType)
 			, _Size(instance._Size)
 		{
@@ -45,8 +47,7 @@ namespace LiongPlus
 		{
 			_Size = instance.GetSize();
 			_PixelType = instance.GetPixelType();
-			_Buffer = Buffer(instance._Buffer.Length());
-			memcpy(_Buffer.Field(), instance._Buffer.Field(), instance._Buffer.Length());
+			_Buffer = instance._Buffer;
 			return *this;
 		}
 		Bitmap& Bitmap::operator=(Bitmap&& instance)
@@ -75,12 +76,12 @@ namespace LiongPlus
 				position.Y < 0 || position.Y + size.Height > _Size.Height)
 				return nullptr;
 
-			Buffer buffer(CalculateDataLength(size, _PixelType));
+			Buffer buffer(CalculateDataLength(size, _PixelType), Memory::LargePageResource::Shared());
 
 			size_t pixelLength = CalculatePixelLength(_PixelType);
 			size_t lineData = size.Width * pixelLength;
 			size_t lineOffset = (_Size.Width - size.Width) * pixelLength;
-			Byte* pos = const_cast<Byte*>(_Buffer.Field()) + // Origin
+			const Byte* pos = _Buffer.Field() + // Origin
 				(position.X + position.Y * _Size.Width) * pixelLength; // Offset
 
 			while (size.Height-- > 0)
@@ -123,11 +124,10 @@ namespace LiongPlus
 
 		Buffer Bitmap::Interpret(PixelType pixelType) const
 		{
+			_L_Trace_Span("media", "Bitmap::Interpret");
 			if (pixelType == _PixelType)
 			{
-				Byte* buffer = new Byte[_Buffer.Length()];
-				memcpy(buffer, _Buffer.Field(), _Buffer.Length());
-				return buffer;
+				return _Buffer.Clone(Memory::LargePageResource::Shared());
 			}
 
 			switch (CalculatePixelLength(_PixelType))
@@ -177,7 +177,7 @@ namespace LiongPlus
 		{
 			if (factorOffset < 0)
 				return nullptr;
-			Buffer buffer(_Size.Width * _Size.Height * 3);
+			Buffer buffer(_Size.Width * _Size.Height * 3, Memory::LargePageResource::Shared());
 
 			const Byte* source = _Buffer.Field();
 			for (size_t i = 0; i < _Buffer.Length(); ++i)
@@ -187,7 +187,7 @@ namespace LiongPlus
 
 		Buffer Bitmap::InterpretMonoToQuad(size_t factorOffset) const
 		{
-			Buffer buffer(_Size.Width * _Size.Height * 4);
+			Buffer buffer(_Size.Width * _Size.Height * 4, Memory::LargePageResource::Shared());
 			const Byte* source = _Buffer.Field();
 			for (size_t i = 0; i < _Buffer.Length(); ++i)
 			{
@@ -200,7 +200,7 @@ namespace LiongPlus
 		Buffer Bitmap::InterpretTriToMono(size_t factorOffset) const
 		{
 			long pixelCount = _Size.Width * _Size.Height;
-			Buffer buffer(pixelCount);
+			Buffer buffer(pixelCount, Memory::LargePageResource::Shared());
 			const Byte* source = _Buffer.Field();
 			for (int i = 0; i < pixelCount; ++i)
 				buffer[i] = source[i * 3 + factorOffset];
@@ -210,7 +210,7 @@ namespace LiongPlus
 		Buffer Bitmap::InterpretTriToTri() const
 		{
 			long pixelCount = _Size.Width * _Size.Height * 3;
-			Buffer buffer(pixelCount);
+			Buffer buffer(pixelCount, Memory::LargePageResource::Shared());
 			const Byte* source = _Buffer.Field();
 			for (int i = 0; i < pixelCount; i += 3)
 			{
@@ -224,7 +224,7 @@ namespace LiongPlus
 		Buffer Bitmap::InterpretTriToQuad(bool shouldInverse) const
 		{
 			long pixelCount = _Size.Width * _Size.Height;
-			Buffer buffer(pixelCount * 4);
+			Buffer buffer(pixelCount * 4, Memory::LargePageResource::Shared());
 			const Byte* source = _Buffer.Field();
 			if (shouldInverse)
 			{
@@ -252,7 +252,7 @@ namespace LiongPlus
 		Buffer Bitmap::InterpretQuadToMono(size_t factorOffset) const
 		{
 			long pixelCount = _Size.Width * _Size.Height;
-			Buffer buffer(pixelCount);
+			Buffer buffer(pixelCount, Memory::LargePageResource::Shared());
 			const Byte* source = _Buffer.Field();
 			for (int i = 0; i < pixelCount; ++i)
 				buffer[i] = source[i * 4 + factorOffset];
@@ -262,7 +262,7 @@ namespace LiongPlus
 		Buffer Bitmap::InterpretQuadToTri(bool shouldInverse) const
 		{
 			long pixelCount = _Size.Width * _Size.Height;
-			Buffer buffer(pixelCount * 3);
+			Buffer buffer(pixelCount * 3, Memory::LargePageResource::Shared());
 			const Byte* source = _Buffer.Field();
 			if (shouldInverse)
 			{
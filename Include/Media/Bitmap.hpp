@@ -5,6 +5,7 @@
 #define Bitmap_hpp
 #include "Fundamental.hpp"
 #include "Buffer.hpp"
+#include "SharedBuffer.hpp"
 #include "Image.hpp"
 
 using namespace LiongPlus;
@@ -48,7 +49,8 @@ namespace LiongPlus
 			virtual Buffer Interpret(PixelType pixelType) const override;
 
 		private:
-			Buffer _Buffer;
+			// Shared between copies; bitmaps are never modified in place.
+			SharedBuffer _Buffer;
 			PixelType _PixelType;
 			Size _Size;
 
@@ -0,0 +1,122 @@
+// File: Allocation.cpp
+// Author: Rendong Liang (Liong)
+#include "Allocation.hpp"
+
+namespace LiongPlus
+{
+	namespace Memory
+	{
+		static std::atomic<IAllocationHook*> _Hook(nullptr);
+		static thread_local const char* _Scope = nullptr;
+
+		IAllocationHook* SetAllocationHook(IAllocationHook* hook)
+		{
+			return _Hook.exchange(hook);
+		}
+		IAllocationHook* GetAllocationHook()
+		{
+			return _Hook.load(std::memory_order_acquire);
+		}
+
+
+
+		AllocationScope::AllocationScope(const char* name)
+			: _Previous(_Scope)
+		{
+			_Scope = name;
+		}
+		AllocationScope::~AllocationScope()
+		{
+			_Scope = _Previous;
+		}
+
+		const char* AllocationScope::Current()
+		{
+			return _Scope;
+		}
+
+
+
+		std::string AllocationTracker::Report::ToString() const
+		{
+			std::stringstream ss;
+			ss << Total.Allocations << " allocations, " << Total.AllocatedBytes << " bytes; "
+				<< Total.Frees << " frees, " << Total.FreedBytes << " bytes\n";
+			for (auto& site : Sites)
+			{
+				ss << "  " << std::setw(10) << site.Allocations << std::setw(14) << site.AllocatedBytes << "  "
+					<< site.Site->Name << " (" << site.Site->File << ':' << site.Site->Line << ')';
+				if (site.Scope != nullptr)
+					ss << " in " << site.Scope;
+				ss << '\n';
+			}
+			return ss.str();
+		}
+
+		AllocationTracker::AllocationTracker()
+			: _Mutex()
+			, _SizeClasses()
+			, _Sites()
+		{
+		}
+
+		void AllocationTracker::OnAllocate(const AllocationSite& site, const char* scope, size_t size)
+		{
+			std::lock_guard<std::mutex> lock(_Mutex);
+			auto& sizeClass = _SizeClasses[SizeClassOf(size)];
+			++sizeClass.Allocations;
+			sizeClass.AllocatedBytes += size;
+			auto& siteStats = _Sites[std::make_pair(&site, scope)];
+			siteStats.Site = &site;
+			siteStats.Scope = scope;
+			++siteStats.Allocations;
+			siteStats.AllocatedBytes += size;
+		}
+		void AllocationTracker::OnFree(const AllocationSite& /*site*/, size_t size)
+		{
+			std::lock_guard<std::mutex> lock(_Mutex);
+			auto& sizeClass = _SizeClasses[SizeClassOf(size)];
+			++sizeClass.Frees;
+			sizeClass.FreedBytes += size;
+		}
+
+		AllocationTracker::Report AllocationTracker::Snapshot()
+		{
+			Report report = {};
+			std::lock_guard<std::mutex> lock(_Mutex);
+			for (int i = 0; i < SIZE_CLASS_COUNT; ++i)
+			{
+				report.SizeClasses[i] = _SizeClasses[i];
+				report.Total.Allocations += _SizeClasses[i].Allocations;
+				report.Total.AllocatedBytes += _SizeClasses[i].AllocatedBytes;
+				report.Total.Frees += _SizeClasses[i].Frees;
+				report.Total.FreedBytes += _SizeClasses[i].FreedBytes;
+			}
+			for (auto& pair : _Sites)
+				report.Sites.push_back(pair.second);
+			std::sort(report.Sites.begin(), report.Sites.end(), [](const SiteStats& a, const SiteStats& b)
+			{
+				return a.AllocatedBytes > b.AllocatedBytes;
+			});
+			return report;
+		}
+
+		void AllocationTracker::Reset()
+		{
+			std::lock_guard<std::mutex> lock(_Mutex);
+			for (auto& sizeClass : _SizeClasses)
+				sizeClass = Stats();
+			_Sites.clear();
+		}
+
+		int AllocationTracker::SizeClassOf(size_t size)
+		{
+			if (size == 0)
+				return 0;
+			int sizeClass = 1;
+			while (sizeClass < SIZE_CLASS_COUNT - 1 && ((size_t)1 << (sizeClass - 1)) < size)
+				++sizeClass;
+			return sizeClass;
+		}
+	}
+}
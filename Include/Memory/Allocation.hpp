@@ -0,0 +1,121 @@
+// File: Allocation.hpp
+// Author: Rendong Liang (Liong)
+
+#ifndef _L_Allocation
+#define _L_Allocation
+#include "../Fundamental.hpp"
+
+namespace LiongPlus
+{
+	namespace Memory
+	{
+		/*
+		 * Where memory is allocated. One static instance lives at each allocating call site, so hooks can key on its address.
+		 */
+		struct AllocationSite
+		{
+			const char* Name;
+			const char* File;
+			int Line;
+		};
+
+		/*
+		 * Observes every allocation made through a MemoryResource. Called on the allocating thread, so implementations must be thread-safe.
+		 */
+		class IAllocationHook
+		{
+		public:
+			virtual ~IAllocationHook() {}
+
+			/*
+			 * [param] scope The innermost allocation scope of the calling thread, or nullptr if there is none.
+			 */
+			virtual void OnAllocate(const AllocationSite& site, const char* scope, size_t size) = 0;
+			virtual void OnFree(const AllocationSite& site, size_t size) = 0;
+		};
+
+		/*
+		 * Install $hook, or remove the current one if $hook is nullptr. The caller must keep the hook alive while it is installed and while allocations made under it may still be freed.
+		 * [return] The hook previously installed.
+		 */
+		IAllocationHook* SetAllocationHook(IAllocationHook* hook);
+		IAllocationHook* GetAllocationHook();
+
+		/*
+		 * Attributes allocations made on the calling thread during its lifetime to $name, e.g. the request being served. Scopes nest; the innermost one wins.
+		 * $name must outlive every hook that sees it, e.g. a string literal.
+		 */
+		class AllocationScope
+		{
+		private:
+			const char* _Previous;
+		public:
+			AllocationScope(const char* name);
+			AllocationScope(const AllocationScope&) = delete;
+			AllocationScope(AllocationScope&&) = delete;
+			~AllocationScope();
+
+			/*
+			 * [return] The innermost scope of the calling thread, or nullptr.
+			 */
+			static const char* Current();
+		};
+
+		/*
+		 * Counts allocations and bytes by call site, scope and size class while installed as the allocation hook.
+		 */
+		class AllocationTracker
+			: public IAllocationHook
+		{
+		public:
+			// Size class i > 0 holds sizes in (2^(i-2), 2^(i-1)], so class 1 holds single bytes; class 0 holds empty allocations.
+			static const int SIZE_CLASS_COUNT = 65;
+
+			struct Stats
+			{
+				uint64_t Allocations, AllocatedBytes, Frees, FreedBytes;
+			};
+			// Frees are not attributed to scopes, so sites only count allocations.
+			struct SiteStats
+			{
+				const AllocationSite* Site;
+				const char* Scope;
+				uint64_t Allocations, AllocatedBytes;
+			};
+			struct Report
+			{
+				Stats Total;
+				Stats SizeClasses[SIZE_CLASS_COUNT];
+				// Sorted by bytes allocated, largest first.
+				std::vector<SiteStats> Sites;
+
+				std::string ToString() const;
+			};
+		private:
+			std::mutex _Mutex;
+			Stats _SizeClasses[SIZE_CLASS_COUNT];
+			std::map<std::pair<const AllocationSite*, const char*>, SiteStats> _Sites;
+		public:
+			AllocationTracker();
+
+			void OnAllocate(const AllocationSite& site, const char* scope, size_t size) override;
+			void OnFree(const AllocationSite& site, size_t size) override;
+
+			Report Snapshot();
+			void Reset();
+
+			static int SizeClassOf(size_t size);
+		};
+	}
+}
+
+#define _L_Allocation_Site(name) \
+	([]() -> const LiongPlus::Memory::AllocationSite& \
+	{ \
+		static const LiongPlus::Memory::AllocationSite _L_Allocation_Site_Instance = { name, __FILE__, __LINE__ }; \
+		return _L_Allocation_Site_Instance; \
+	}())
+#define _L_Allocation_Concat_(a, b) a##b
+#define _L_Allocation_Concat(a, b) _L_Allocation_Concat_(a, b)
+#define _L_Allocation_Scope(name) LiongPlus::Memory::AllocationScope _L_Allocation_Concat(_L_Allocation_Scope_, __LINE__)(name)
+#endif
@@ -0,0 +1,202 @@
+// File: LargePageResource.cpp
+// Author: Rendong Liang (Liong)
+#include "LargePageResource.hpp"
+
+#ifdef _L_LINUX
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace LiongPlus
+{
+	namespace Memory
+	{
+		static const size_t SMALL_PAGE_SIZE = 4096;
+#ifdef _L_LINUX
+		// From <numaif.h>, which is not installed without libnuma.
+		static const int MPOL_PREFERRED_ = 1;
+#endif
+
+		static size_t RoundUp(size_t value, size_t unit)
+		{
+			return (value + unit - 1) / unit * unit;
+		}
+
+		static size_t HugePageSize()
+		{
+#ifdef _L_WINDOWS
+			static const size_t size = GetLargePageMinimum();
+			return size != 0 ? size : LargePageResource::HUGE_PAGE_SIZE;
+#else
+			return LargePageResource::HUGE_PAGE_SIZE;
+#endif
+		}
+
+		// Allocations that span a huge page are mapped in whole huge pages, the rest in normal ones. Deallocation recomputes the same length from the size.
+		static size_t MappingLength(size_t size)
+		{
+			return size >= HugePageSize() ? RoundUp(size, HugePageSize()) : RoundUp(size, SMALL_PAGE_SIZE);
+		}
+
+		LargePageResource::LargePageResource(size_t threshold, bool isNodeLocal)
+			: _Threshold(threshold)
+			, _IsNodeLocal(isNodeLocal)
+			, _Stats()
+		{
+			_Stats.HugeTlbMappings = 0;
+			_Stats.TransparentMappings = 0;
+			_Stats.PlainMappings = 0;
+			_Stats.NodeBindings = 0;
+		}
+
+		size_t LargePageResource::Threshold() const
+		{
+			return _Threshold;
+		}
+		const LargePageResource::Stats& LargePageResource::GetStats() const
+		{
+			return _Stats;
+		}
+
+		LargePageResource* LargePageResource::Shared()
+		{
+			static LargePageResource resource;
+			return &resource;
+		}
+
+		// Protected
+
+		void* LargePageResource::DoAllocate(size_t size, size_t alignment)
+		{
+#if defined(_L_LINUX) || defined(_L_WINDOWS)
+			if (size >= _Threshold && size != 0 && alignment <= SMALL_PAGE_SIZE)
+				return Map(MappingLength(size));
+#endif
+			// Not through NewDelete()->Allocate(), which would report to the hook a second time.
+			if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+				return ::operator new(size, std::align_val_t(alignment));
+			return ::operator new(size);
+		}
+		void LargePageResource::DoDeallocate(void* ptr, size_t size, size_t alignment)
+		{
+#if defined(_L_LINUX) || defined(_L_WINDOWS)
+			if (size >= _Threshold && size != 0 && alignment <= SMALL_PAGE_SIZE)
+			{
+#ifdef _L_WINDOWS
+				VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+				munmap(ptr, MappingLength(size));
+#endif
+				return;
+			}
+#endif
+			if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+				::operator delete(ptr, std::align_val_t(alignment));
+			else
+				::operator delete(ptr);
+		}
+
+		void* LargePageResource::DoReallocate(void* ptr, size_t oldSize, size_t newSize, size_t alignment)
+		{
+#ifdef _L_LINUX
+			// Both sides mapped: move the page table entries instead of the bytes.
+			if (oldSize >= _Threshold && newSize >= _Threshold && alignment <= SMALL_PAGE_SIZE)
+			{
+				auto oldLength = MappingLength(oldSize), newLength = MappingLength(newSize);
+				if (oldLength == newLength)
+					return ptr;
+				// Fails on huge TLB mappings of older kernels, which then fall back to copying.
+				auto newPtr = mremap(ptr, oldLength, newLength, MREMAP_MAYMOVE);
+				if (newPtr != MAP_FAILED)
+				{
+					if (newLength > oldLength && newLength % HUGE_PAGE_SIZE == 0)
+						madvise(newPtr, newLength, MADV_HUGEPAGE);
+					return newPtr;
+				}
+			}
+#endif
+			return nullptr;
+		}
+
+		// Private
+
+		void* LargePageResource::Map(size_t length)
+		{
+#if defined(_L_WINDOWS)
+			PROCESSOR_NUMBER processor;
+			USHORT node = 0;
+			GetCurrentProcessorNumberEx(&processor);
+			bool isBound = _IsNodeLocal && GetNumaProcessorNodeEx(&processor, &node);
+			auto map = [&](DWORD flags) -> void*
+			{
+				return isBound ?
+					VirtualAllocExNuma(GetCurrentProcess(), nullptr, length, flags, PAGE_READWRITE, node) :
+					VirtualAlloc(nullptr, length, flags, PAGE_READWRITE);
+			};
+
+			// Needs SeLockMemoryPrivilege; fails without it.
+			void* ptr = nullptr;
+			if (length % HugePageSize() == 0)
+				ptr = map(MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES);
+			if (ptr != nullptr)
+				++_Stats.HugeTlbMappings;
+			else
+			{
+				ptr = map(MEM_RESERVE | MEM_COMMIT);
+				if (ptr == nullptr)
+					throw std::bad_alloc();
+				++_Stats.PlainMappings;
+			}
+			if (isBound)
+				++_Stats.NodeBindings;
+			return ptr;
+#elif defined(_L_LINUX)
+			void* ptr = MAP_FAILED;
+			// Only succeeds if huge pages are reserved, e.g. through /proc/sys/vm/nr_hugepages.
+			if (length % HUGE_PAGE_SIZE == 0)
+				ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+			if (ptr != MAP_FAILED)
+				++_Stats.HugeTlbMappings;
+			else if (length % HUGE_PAGE_SIZE == 0)
+			{
+				// Transparent huge pages only cover aligned ranges, so over-map and trim down to an aligned one.
+				auto raw = (Byte*)mmap(nullptr, length + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+				if (raw == MAP_FAILED)
+					throw std::bad_alloc();
+				auto aligned = (Byte*)RoundUp((uintptr_t)raw, HUGE_PAGE_SIZE);
+				if (aligned != raw)
+					munmap(raw, aligned - raw);
+				if (raw + HUGE_PAGE_SIZE != aligned)
+					munmap(aligned + length, raw + HUGE_PAGE_SIZE - aligned);
+				ptr = aligned;
+				if (madvise(ptr, length, MADV_HUGEPAGE) == 0)
+					++_Stats.TransparentMappings;
+				else
+					++_Stats.PlainMappings;
+			}
+			else
+			{
+				ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+				if (ptr == MAP_FAILED)
+					throw std::bad_alloc();
+				++_Stats.PlainMappings;
+			}
+
+			if (_IsNodeLocal)
+			{
+				// Pages are not touched yet, so the policy decides where all of them land. Preferred rather than bound, so a full node spills over instead of failing.
+				unsigned cpu, node;
+				if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0 && node < 64)
+				{
+					unsigned long mask = 1ul << node;
+					if (syscall(SYS_mbind, ptr, length, MPOL_PREFERRED_, &mask, sizeof(mask) * 8 + 1, 0) == 0)
+						++_Stats.NodeBindings;
+				}
+			}
+			return ptr;
+#else
+			throw std::bad_alloc();
+#endif
+		}
+	}
+}
@@ -0,0 +1,59 @@
+// File: LargePageResource.hpp
+// Author: Rendong Liang (Liong)
+
+#ifndef _L_LargePageResource
+#define _L_LargePageResource
+#include "../Fundamental.hpp"
+#include "MemoryResource.hpp"
+
+namespace LiongPlus
+{
+	namespace Memory
+	{
+		/*
+		 * Maps allocations of at least $Threshold bytes straight from the system, backed by huge pages where possible, to cut TLB misses over large frames and streams. Smaller ones go to NewDelete().
+		 * Huge pages are tried in order: explicit ones (MAP_HUGETLB, MEM_LARGE_PAGES), then transparent ones (MADV_HUGEPAGE), then normal pages. Each step is skipped silently where the system does not offer it.
+		 */
+		class LargePageResource
+			: public MemoryResource
+		{
+		public:
+			static const size_t DEFAULT_THRESHOLD = 1024 * 1024;
+			static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+			struct Stats
+			{
+				// Large allocations and how they ended up backed.
+				std::atomic<uint64_t> HugeTlbMappings, TransparentMappings, PlainMappings;
+				// Allocations bound to the node of the allocating thread.
+				std::atomic<uint64_t> NodeBindings;
+			};
+		private:
+			size_t _Threshold;
+			bool _IsNodeLocal;
+			Stats _Stats;
+
+			void* Map(size_t length);
+		protected:
+			void* DoAllocate(size_t size, size_t alignment) override;
+			void DoDeallocate(void* ptr, size_t size, size_t alignment) override;
+			void* DoReallocate(void* ptr, size_t oldSize, size_t newSize, size_t alignment) override;
+		public:
+			/*
+			 * [param] isNodeLocal Prefer the NUMA node of the allocating thread for the pages of large allocations, regardless of which thread touches them first.
+			 */
+			LargePageResource(size_t threshold = DEFAULT_THRESHOLD, bool isNodeLocal = true);
+			LargePageResource(const LargePageResource&) = delete;
+			LargePageResource(LargePageResource&&) = delete;
+
+			size_t Threshold() const;
+			const Stats& GetStats() const;
+
+			/*
+			 * [return] A process-wide instance with the default threshold, for large media and stream buffers.
+			 */
+			static LargePageResource* Shared();
+		};
+	}
+}
+#endif
@@ -0,0 +1,107 @@
+// File: MemoryResource.cpp
+// Author: Rendong Liang (Liong)
+#include "MemoryResource.hpp"
+
+namespace LiongPlus
+{
+	namespace Memory
+	{
+		class NewDeleteResource
+			: public MemoryResource
+		{
+		protected:
+			void* DoAllocate(size_t size, size_t alignment) override
+			{
+				if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+					return ::operator new(size, std::align_val_t(alignment));
+				return ::operator new(size);
+			}
+			void DoDeallocate(void* ptr, size_t /*size*/, size_t alignment) override
+			{
+				if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+					::operator delete(ptr, std::align_val_t(alignment));
+				else
+					::operator delete(ptr);
+			}
+		};
+
+		static std::atomic<MemoryResource*> _Default(nullptr);
+		static thread_local MemoryResource* _ThreadDefault = nullptr;
+
+		void* MemoryResource::Allocate(size_t size, size_t alignment, const AllocationSite& site)
+		{
+			auto ptr = DoAllocate(size, alignment);
+			auto hook = GetAllocationHook();
+			if (hook != nullptr)
+				hook->OnAllocate(site, AllocationScope::Current(), size);
+			return ptr;
+		}
+		void MemoryResource::Deallocate(void* ptr, size_t size, size_t alignment, const AllocationSite& site)
+		{
+			if (ptr == nullptr)
+				return;
+			auto hook = GetAllocationHook();
+			if (hook != nullptr)
+				hook->OnFree(site, size);
+			DoDeallocate(ptr, size, alignment);
+		}
+
+		void* MemoryResource::Reallocate(void* ptr, size_t oldSize, size_t newSize, size_t alignment, const AllocationSite& site)
+		{
+			if (ptr == nullptr)
+				return Allocate(newSize, alignment, site);
+			auto newPtr = DoReallocate(ptr, oldSize, newSize, alignment);
+			if (newPtr == nullptr)
+			{
+				newPtr = DoAllocate(newSize, alignment);
+				std::memcpy(newPtr, ptr, oldSize < newSize ? oldSize : newSize);
+				DoDeallocate(ptr, oldSize, alignment);
+			}
+			auto hook = GetAllocationHook();
+			if (hook != nullptr)
+			{
+				hook->OnFree(site, oldSize);
+				hook->OnAllocate(site, AllocationScope::Current(), newSize);
+			}
+			return newPtr;
+		}
+
+		bool MemoryResource::IsEqual(const MemoryResource& other) const
+		{
+			return this == &other || DoIsEqual(other);
+		}
+		bool MemoryResource::DoIsEqual(const MemoryResource& /*other*/) const
+		{
+			return false;
+		}
+		void* MemoryResource::DoReallocate(void* /*ptr*/, size_t /*oldSize*/, size_t /*newSize*/, size_t /*alignment*/)
+		{
+			return nullptr;
+		}
+
+		MemoryResource* MemoryResource::NewDelete()
+		{
+			static NewDeleteResource resource;
+			return &resource;
+		}
+
+		MemoryResource* MemoryResource::Default()
+		{
+			if (_ThreadDefault != nullptr)
+				return _ThreadDefault;
+			auto resource = _Default.load(std::memory_order_acquire);
+			return resource != nullptr ? resource : NewDelete();
+		}
+		MemoryResource* MemoryResource::SetDefault(MemoryResource* resource)
+		{
+			auto previous = _Default.exchange(resource);
+			return previous != nullptr ? previous : NewDelete();
+		}
+		MemoryResource* MemoryResource::SetThreadDefault(MemoryResource* resource)
+		{
+			auto previous = _ThreadDefault;
+			_ThreadDefault = resource;
+			return previous;
+		}
+	}
+}
@@ -0,0 +1,111 @@
+// File: MemoryResource.hpp
+// Author: Rendong Liang (Liong)
+
+#ifndef _L_MemoryResource
+#define _L_MemoryResource
+#include "../Fundamental.hpp"
+#include "Allocation.hpp"
+
+namespace LiongPlus
+{
+	namespace Memory
+	{
+		/*
+		 * A source of memory that containers take at construction and free back to, in the spirit of std::pmr::memory_resource. Implement DoAllocate() and DoDeallocate() to plug in arenas, pools or page-backed allocators.
+		 * Every allocation goes through Allocate(), so installed allocation hooks see all resources alike.
+		 */
+		class MemoryResource
+		{
+		protected:
+			virtual void* DoAllocate(size_t size, size_t alignment) = 0;
+			virtual void DoDeallocate(void* ptr, size_t size, size_t alignment) = 0;
+			/*
+			 * [return] True if memory from $other can be freed to this resource.
+			 */
+			virtual bool DoIsEqual(const MemoryResource& other) const;
+			/*
+			 * Grow or shrink $ptr, preserving its content, without going through a separate allocation and copy.
+			 * [return] The new address, or nullptr if the resource cannot do better than allocate-copy-free, in which case $ptr is untouched.
+			 */
+			virtual void* DoReallocate(void* ptr, size_t oldSize, size_t newSize, size_t alignment);
+		public:
+			virtual ~MemoryResource() {}
+
+			/*
+			 * Throws std::bad_alloc on failure.
+			 */
+			void* Allocate(size_t size, size_t alignment, const AllocationSite& site);
+			/*
+			 * $size and $alignment must be those $ptr was allocated with.
+			 */
+			void Deallocate(void* ptr, size_t size, size_t alignment, const AllocationSite& site);
+			/*
+			 * Resize an allocation, keeping the first min($oldSize, $newSize) bytes. In place where the resource supports it, e.g. mremap(2) for mapped memory; otherwise by allocate, copy and free.
+			 * Throws std::bad_alloc on failure, leaving $ptr valid.
+			 */
+			void* Reallocate(void* ptr, size_t oldSize, size_t newSize, size_t alignment, const AllocationSite& site);
+			bool IsEqual(const MemoryResource& other) const;
+
+			/*
+			 * [return] The resource backed by global operator new and delete.
+			 */
+			static MemoryResource* NewDelete();
+			/*
+			 * [return] The resource containers use unless given one: the default of the calling thread if set, otherwise that of the process.
+			 */
+			static MemoryResource* Default();
+			/*
+			 * Replace the default resource of the process. nullptr restores NewDelete().
+			 * [return] The previous default.
+			 */
+			static MemoryResource* SetDefault(MemoryResource* resource);
+			/*
+			 * Replace the default resource of the calling thread, e.g. with a per-request arena. nullptr falls back to the default of the process.
+			 * [return] The previous default of the thread, possibly nullptr.
+			 */
+			static MemoryResource* SetThreadDefault(MemoryResource* resource);
+		};
+
+		/*
+		 * Allocate $count objects from $resource and default-initialize them, the way new T[$count] does.
+		 */
+		template<typename T>
+		T* NewArray(MemoryResource* resource, size_t count, const AllocationSite& site)
+		{
+			auto ptr = static_cast<T*>(resource->Allocate(count * sizeof(T), alignof(T), site));
+			// Default-initialization of PODs does nothing; don't rely on the optimizer to see that.
+			if (std::is_trivially_default_constructible<T>::value)
+				return ptr;
+			size_t i = 0;
+			try
+			{
+				for (; i < count; ++i)
+					new (ptr + i) T;
+			}
+			catch (...)
+			{
+				while (i-- > 0)
+					ptr[i].~T();
+				resource->Deallocate(ptr, count * sizeof(T), alignof(T), site);
+				throw;
+			}
+			return ptr;
+		}
+		/*
+		 * Destroy and free objects got from NewArray().
+		 */
+		template<typename T>
+		void DeleteArray(MemoryResource* resource, T* ptr, size_t count, const AllocationSite& site)
+		{
+			if (ptr == nullptr)
+				return;
+			if (!std::is_trivially_destructible<T>::value)
+			{
+				for (size_t i = count; i-- > 0;)
+					ptr[i].~T();
+			}
+			resource->Deallocate(ptr, count * sizeof(T), alignof(T), site);
+		}
+	}
+}
+#endif
@@ -0,0 +1,205 @@
+// File: MonotonicArena.cpp
+// Author: Rendong Liang (Liong)
+#include "MonotonicArena.hpp"
+
+namespace LiongPlus
+{
+	namespace Memory
+	{
+		// Keeps the payload of every chunk aligned as operator new would.
+		static const size_t HEADER_SIZE = (sizeof(MonotonicArena::Chunk) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+		static const size_t MAX_CACHED_CHUNKS = MonotonicArena::MAX_CACHED_BYTES_PER_THREAD / MonotonicArena::CHUNK_SIZE;
+
+		struct ChunkCache
+		{
+			MonotonicArena::Chunk* Head = nullptr;
+			size_t Count = 0;
+
+			void Clear()
+			{
+				while (Head != nullptr)
+				{
+					auto next = Head->Next;
+					::operator delete(Head);
+					Head = next;
+				}
+				Count = 0;
+			}
+			~ChunkCache()
+			{
+				Clear();
+			}
+		};
+		static thread_local ChunkCache _Cache;
+
+		static inline uintptr_t AlignUp(uintptr_t value, size_t alignment)
+		{
+			return (value + alignment - 1) & ~(uintptr_t)(alignment - 1);
+		}
+
+
+
+		MonotonicArena::Scope::Scope(MonotonicArena& arena)
+			: _Arena(arena)
+			, _Previous(MemoryResource::SetThreadDefault(&arena))
+		{
+		}
+		MonotonicArena::Scope::~Scope()
+		{
+			MemoryResource::SetThreadDefault(_Previous);
+			_Arena.Reset();
+		}
+
+
+
+		MonotonicArena::MonotonicArena()
+			: _Head(nullptr)
+			, _Tail(nullptr)
+			, _ChunkCount(0)
+			, _Large(nullptr)
+			, _Cursor(nullptr)
+			, _End(nullptr)
+			, _Last(nullptr)
+			, _AllocatedBytes(0)
+		{
+		}
+		MonotonicArena::~MonotonicArena()
+		{
+			Reset();
+		}
+
+		void MonotonicArena::Reset()
+		{
+			while (_Large != nullptr)
+			{
+				auto next = _Large->Next;
+				::operator delete(_Large);
+				_Large = next;
+			}
+
+			if (_Head != nullptr)
+			{
+				if (_Cache.Count + _ChunkCount <= MAX_CACHED_CHUNKS)
+				{
+					_Tail->Next = _Cache.Head;
+					_Cache.Head = _Head;
+					_Cache.Count += _ChunkCount;
+				}
+				else
+				{
+					// Only reached when many arenas release at once; keep what fits.
+					while (_Head != nullptr)
+					{
+						auto next = _Head->Next;
+						if (_Cache.Count < MAX_CACHED_CHUNKS)
+						{
+							_Head->Next = _Cache.Head;
+							_Cache.Head = _Head;
+							++_Cache.Count;
+						}
+						else
+							::operator delete(_Head);
+						_Head = next;
+					}
+				}
+			}
+
+			_Head = _Tail = nullptr;
+			_ChunkCount = 0;
+			_Cursor = _End = _Last = nullptr;
+			_AllocatedBytes = 0;
+		}
+
+		size_t MonotonicArena::AllocatedBytes() const
+		{
+			return _AllocatedBytes;
+		}
+		size_t MonotonicArena::ReservedBytes() const
+		{
+			size_t reserved = _ChunkCount * CHUNK_SIZE;
+			for (auto chunk = _Large; chunk != nullptr; chunk = chunk->Next)
+				reserved += chunk->Size;
+			return reserved;
+		}
+
+		size_t MonotonicArena::CachedBytes()
+		{
+			return _Cache.Count * CHUNK_SIZE;
+		}
+		void MonotonicArena::Trim()
+		{
+			_Cache.Clear();
+		}
+
+		// Protected
+
+		void* MonotonicArena::DoAllocate(size_t size, size_t alignment)
+		{
+			auto aligned = AlignUp((uintptr_t)_Cursor, alignment);
+			if (_Cursor != nullptr && aligned + size <= (uintptr_t)_End)
+			{
+				_Last = (Byte*)aligned;
+				_Cursor = _Last + size;
+				_AllocatedBytes += size;
+				return _Last;
+			}
+			return AllocateSlow(size, alignment);
+		}
+		void MonotonicArena::DoDeallocate(void* ptr, size_t size, size_t /*alignment*/)
+		{
+			// Give back the latest allocation, so that a container growing at the top of the arena does not leave its old storage behind.
+			if (ptr == _Last && _Last + size == _Cursor)
+			{
+				_Cursor = _Last;
+				_Last = nullptr;
+				_AllocatedBytes -= size;
+			}
+		}
+
+		void* MonotonicArena::DoReallocate(void* ptr, size_t oldSize, size_t newSize, size_t /*alignment*/)
+		{
+			// Only the latest allocation has free space behind it.
+			if (ptr != _Last || _Last + oldSize != _Cursor || newSize > (size_t)(_End - _Last))
+				return nullptr;
+			_Cursor = _Last + newSize;
+			_AllocatedBytes = _AllocatedBytes - oldSize + newSize;
+			return ptr;
+		}
+
+		// Private
+
+		void* MonotonicArena::AllocateSlow(size_t size, size_t alignment)
+		{
+			if (HEADER_SIZE + size + alignment > CHUNK_SIZE)
+			{
+				auto chunkSize = HEADER_SIZE + size + alignment;
+				auto chunk = static_cast<Chunk*>(::operator new(chunkSize));
+				chunk->Next = _Large;
+				chunk->Size = chunkSize;
+				_Large = chunk;
+				_AllocatedBytes += size;
+				return (void*)AlignUp((uintptr_t)chunk + HEADER_SIZE, alignment);
+			}
+
+			Chunk* chunk;
+			if (_Cache.Head != nullptr)
+			{
+				chunk = _Cache.Head;
+				_Cache.Head = chunk->Next;
+				--_Cache.Count;
+			}
+			else
+				chunk = static_cast<Chunk*>(::operator new(CHUNK_SIZE));
+			chunk->Next = _Head;
+			chunk->Size = CHUNK_SIZE;
+			if (_Head == nullptr)
+				_Tail = chunk;
+			_Head = chunk;
+			++_ChunkCount;
+
+			_Cursor = (Byte*)chunk + HEADER_SIZE;
+			_End = (Byte*)chunk + CHUNK_SIZE;
+			return DoAllocate(size, alignment);
+		}
+	}
+}
@@ -0,0 +1,97 @@
+// File: MonotonicArena.hpp
+// Author: Rendong Liang (Liong)
+
+#ifndef _L_MonotonicArena
+#define _L_MonotonicArena
+#include "../Fundamental.hpp"
+#include "MemoryResource.hpp"
+
+namespace LiongPlus
+{
+	namespace Memory
+	{
+		/*
+		 * A bump allocator for objects that die together, e.g. everything built to serve one request. Deallocate() frees nothing except the latest allocation; Reset() frees everything at once.
+		 * Chunks are not returned to the system but kept in a cache of the thread that releases them, so that steady-state requests never reach malloc.
+		 * Not thread-safe: an arena is used by one thread at a time.
+		 */
+		class MonotonicArena
+			: public MemoryResource
+		{
+		public:
+			// Size of pooled chunks, header included. Larger allocations get a chunk of their own, which is freed at reset.
+			static const size_t CHUNK_SIZE = 64 * 1024;
+			// Bytes of chunks each thread keeps for reuse. Chunks released beyond that go back to the system.
+			static const size_t MAX_CACHED_BYTES_PER_THREAD = 4 * 1024 * 1024;
+
+			struct Chunk
+			{
+				Chunk* Next;
+				size_t Size;
+			};
+
+			/*
+			 * Installs an arena as the default resource of the calling thread and resets it when leaving the scope.
+			 * Must not span a co_await: the coroutine may resume on another thread, and other coroutines of this thread would allocate from the arena.
+			 */
+			class Scope
+			{
+			private:
+				MonotonicArena& _Arena;
+				MemoryResource* _Previous;
+			public:
+				Scope(MonotonicArena& arena);
+				Scope(const Scope&) = delete;
+				Scope(Scope&&) = delete;
+				~Scope();
+			};
+		private:
+			// Pooled chunks, newest first. $_Tail is the oldest so that the whole list can be spliced into the cache.
+			Chunk* _Head;
+			Chunk* _Tail;
+			size_t _ChunkCount;
+			// Oversized chunks, freed one by one at reset.
+			Chunk* _Large;
+			Byte* _Cursor;
+			Byte* _End;
+			Byte* _Last;
+			size_t _AllocatedBytes;
+
+			void* AllocateSlow(size_t size, size_t alignment);
+		protected:
+			void* DoAllocate(size_t size, size_t alignment) override;
+			void DoDeallocate(void* ptr, size_t size, size_t alignment) override;
+			void* DoReallocate(void* ptr, size_t oldSize, size_t newSize, size_t alignment) override;
+		public:
+			MonotonicArena();
+			MonotonicArena(const MonotonicArena&) = delete;
+			MonotonicArena(MonotonicArena&&) = delete;
+			~MonotonicArena();
+
+			/*
+			 * Free everything allocated from the arena. Pooled chunks are handed to the cache of the calling thread in O(1).
+			 * Objects allocated from the arena must be destroyed beforehand if they own anything outside of it.
+			 */
+			void Reset();
+
+			/*
+			 * [return] Bytes handed out since the last reset, padding excluded.
+			 */
+			size_t AllocatedBytes() const;
+			/*
+			 * [return] Bytes of chunks the arena currently holds.
+			 */
+			size_t ReservedBytes() const;
+
+			/*
+			 * [return] Bytes of chunks cached by the calling thread.
+			 */
+			static size_t CachedBytes();
+			/*
+			 * Return the chunks cached by the calling thread to the system.
+			 */
+			static void Trim();
+		};
+	}
+}
+#endif
@@ -0,0 +1,287 @@
+// File: Async.cpp
+// Author: Rendong Liang (Liong)
+#include "Async.hpp"
+
+#ifdef _L_COROUTINE
+namespace LiongPlus
+{
+	namespace Net
+	{
+		namespace Detail
+		{
+			void DetachedTask::promise_type::unhandled_exception()
+			{
+				ReportError("Spawned task failed", std::current_exception());
+			}
+
+			// Owns a spawned frame until the loop resumes it, so that a loop destroyed before then destroys the frame instead of leaking it.
+			struct PendingFrame
+			{
+				std::coroutine_handle<> Handle;
+
+				~PendingFrame()
+				{
+					if (Handle)
+						Handle.destroy();
+				}
+			};
+
+			DetachedTask RunDetached(Task<void> task)
+			{
+				co_await task;
+			}
+		}
+
+		void Spawn(EventLoop& loop, Task<void> task)
+		{
+			auto frame = std::make_shared<Detail::PendingFrame>();
+			frame->Handle = Detail::RunDetached(std::move(task)).Handle;
+			loop.Post([frame]
+			{
+				auto handle = frame->Handle;
+				frame->Handle = nullptr;
+				handle.resume();
+			});
+		}
+
+
+
+		SocketAwaiter::SocketAwaiter(Socket& socket, uint32_t events)
+			: _Loop(EventLoop::Current() != nullptr ? *EventLoop::Current() : throw std::logic_error("No event loop is running on current thread."))
+			, _Awaiting(nullptr)
+			, _AwaitEvents(events)
+			, _Socket(socket)
+			, _Error(nullptr)
+		{
+		}
+
+		void SocketAwaiter::Rethrow()
+		{
+			if (_Error)
+				std::rethrow_exception(_Error);
+		}
+
+		bool SocketAwaiter::OnReady()
+		{
+			if (!Perform())
+				return false;
+			_Awaiting.resume();
+			return true;
+		}
+		void SocketAwaiter::OnError(std::exception_ptr error)
+		{
+			// Rethrown by await_resume() in the awaiting coroutine.
+			_Error = error;
+			_Awaiting.resume();
+		}
+
+		bool SocketAwaiter::await_ready()
+		{
+			return Perform();
+		}
+		void SocketAwaiter::await_suspend(std::coroutine_handle<> awaiting)
+		{
+			_Awaiting = awaiting;
+			// The loop might resume the coroutine on its own thread before this returns, so $this must not be touched after watching.
+			_Loop.Watch(_Socket, _AwaitEvents, this);
+		}
+
+
+
+		ReceiveAwaiter::ReceiveAwaiter(Socket& socket, Byte* data, size_t length)
+			: SocketAwaiter(socket, EPOLLIN)
+			, _Data(data)
+			, _Length(length)
+			, _Received(0)
+		{
+		}
+
+		bool ReceiveAwaiter::Perform()
+		{
+			try
+			{
+				_Received = _Socket.TryReceive(_Data, _Length, 0);
+				return _Received >= 0;
+			}
+			catch (...)
+			{
+				_Error = std::current_exception();
+				return true;
+			}
+		}
+
+		size_t ReceiveAwaiter::await_resume()
+		{
+			Rethrow();
+			return _Received;
+		}
+
+
+
+		SendAwaiter::SendAwaiter(Socket& socket, const Byte* data, size_t length)
+			: SocketAwaiter(socket, EPOLLOUT)
+			, _Data(data)
+			, _Length(length)
+			, _Sent(0)
+		{
+		}
+
+		bool SendAwaiter::Perform()
+		{
+			try
+			{
+				while (_Sent < _Length)
+				{
+					auto sent = _Socket.TrySend(_Data + _Sent, _Length - _Sent, 0);
+					if (sent < 0)
+						return false;
+					_Sent += sent;
+				}
+			}
+			catch (...)
+			{
+				_Error = std::current_exception();
+			}
+			return true;
+		}
+
+		size_t SendAwaiter::await_resume()
+		{
+			Rethrow();
+			return _Sent;
+		}
+
+
+
+		SendFileAwaiter::SendFileAwaiter(Socket& socket, int fd, size_t offset, size_t count)
+			: SocketAwaiter(socket, EPOLLOUT)
+			, _Fd(fd)
+			, _Offset(offset)
+			, _Count(count)
+			, _Sent(0)
+		{
+		}
+
+		bool SendFileAwaiter::Perform()
+		{
+			try
+			{
+				while (_Sent < _Count)
+				{
+					auto sent = _Socket.TrySendFile(_Fd, _Offset + _Sent, _Count - _Sent);
+					if (sent < 0)
+						return false;
+					if (sent == 0)
+						throw std::runtime_error("Failed in sending file: $fd ends before $count bytes.");
+					_Sent += sent;
+				}
+			}
+			catch (...)
+			{
+				_Error = std::current_exception();
+			}
+			return true;
+		}
+
+		size_t SendFileAwaiter::await_resume()
+		{
+			Rethrow();
+			return _Sent;
+		}
+
+
+
+		AcceptAwaiter::AcceptAwaiter(Socket& listener, SocketAddress& peer)
+			: SocketAwaiter(listener, EPOLLIN)
+			, _Peer(peer)
+			, _Accepted()
+		{
+		}
+
+		bool AcceptAwaiter::Perform()
+		{
+			try
+			{
+				_Accepted = _Socket.TryAccept(_Peer);
+				return _Accepted.IsValid();
+			}
+			catch (...)
+			{
+				_Error = std::current_exception();
+				return true;
+			}
+		}
+
+		Socket AcceptAwaiter::await_resume()
+		{
+			Rethrow();
+			return std::move(_Accepted);
+		}
+
+
+
+		ConnectAwaiter::ConnectAwaiter(Socket& socket, const SocketAddress& addr)
+			: SocketAwaiter(socket, EPOLLOUT)
+			, _Addr(addr)
+			, _IsStarted(false)
+		{
+		}
+
+		bool ConnectAwaiter::Perform()
+		{
+			try
+			{
+				if (!_IsStarted)
+				{
+					_IsStarted = true;
+					return _Socket.TryConnect(_Addr);
+				}
+				// Writable means the connection attempt has finished, successfully or not.
+				if (_Socket.PendingError() != 0)
+					throw std::runtime_error("Failed in connectiong to a certain address.");
+			}
+			catch (...)
+			{
+				_Error = std::current_exception();
+			}
+			return true;
+		}
+
+		void ConnectAwaiter::await_resume()
+		{
+			Rethrow();
+		}
+
+
+
+		ReceiveAwaiter ReceiveAsync(Socket& socket, Buffer& buffer)
+		{
+			return ReceiveAwaiter(socket, buffer.Field(), buffer.Length());
+		}
+		ReceiveAwaiter ReceiveAsync(Socket& socket, Byte* data, size_t length)
+		{
+			return ReceiveAwaiter(socket, data, length);
+		}
+		SendAwaiter SendAsync(Socket& socket, const Buffer& buffer)
+		{
+			return SendAwaiter(socket, buffer.Field(), buffer.Length());
+		}
+		SendAwaiter SendAsync(Socket& socket, const Byte* data, size_t length)
+		{
+			return SendAwaiter(socket, data, length);
+		}
+		SendFileAwaiter SendFileAsync(Socket& socket, int fd, size_t offset, size_t count)
+		{
+			return SendFileAwaiter(socket, fd, offset, count);
+		}
+		AcceptAwaiter AcceptAsync(Socket& listener, SocketAddress& peer)
+		{
+			return AcceptAwaiter(listener, peer);
+		}
+		ConnectAwaiter ConnectAsync(Socket& socket, const SocketAddress& addr)
+		{
+			return ConnectAwaiter(socket, addr);
+		}
+	}
+}
+#endif // _L_COROUTINE
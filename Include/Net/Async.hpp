@@ -0,0 +1,309 @@
+// File: Async.hpp
+// Author: Rendong Liang (Liong)
+
+#pragma once
+#include "../Fundamental.hpp"
+#include "../Buffer.hpp"
+#include "EventLoop.hpp"
+#include "Socket.hpp"
+
+#if defined(_L_LINUX) && defined(__cpp_impl_coroutine)
+#define _L_COROUTINE
+#include <coroutine>
+
+namespace LiongPlus
+{
+	namespace Net
+	{
+		template<typename T>
+		class Task;
+
+		namespace Detail
+		{
+			class TaskPromiseBase
+			{
+			private:
+				struct FinalAwaiter
+				{
+					bool await_ready() noexcept { return false; }
+					template<typename TPromise>
+					std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> handle) noexcept
+					{
+						auto continuation = handle.promise()._Continuation;
+						return continuation ? continuation : std::noop_coroutine();
+					}
+					void await_resume() noexcept {}
+				};
+			protected:
+				std::exception_ptr _Error;
+			public:
+				std::coroutine_handle<> _Continuation;
+
+				std::suspend_always initial_suspend() noexcept { return {}; }
+				FinalAwaiter final_suspend() noexcept { return {}; }
+				void unhandled_exception() { _Error = std::current_exception(); }
+			};
+
+			template<typename T>
+			class TaskPromise
+				: public TaskPromiseBase
+			{
+			private:
+				alignas(T) Byte _Value[sizeof(T)];
+				bool _HasValue = false;
+			public:
+				~TaskPromise()
+				{
+					if (_HasValue)
+						reinterpret_cast<T*>(_Value)->~T();
+				}
+
+				Task<T> get_return_object();
+				template<typename TValue>
+				void return_value(TValue&& value)
+				{
+					new (_Value) T(std::forward<TValue>(value));
+					_HasValue = true;
+				}
+				T Result()
+				{
+					if (_Error)
+						std::rethrow_exception(_Error);
+					return std::move(*reinterpret_cast<T*>(_Value));
+				}
+			};
+
+			template<>
+			class TaskPromise<void>
+				: public TaskPromiseBase
+			{
+			public:
+				Task<void> get_return_object();
+				void return_void() {}
+				void Result()
+				{
+					if (_Error)
+						std::rethrow_exception(_Error);
+				}
+			};
+		}
+
+		/*
+		 * A lazily started coroutine. The body runs when the task is co_await-ed and resumes the awaiting coroutine by symmetric transfer when done, so no future or callback is allocated.
+		 */
+		template<typename T = void>
+		class Task
+		{
+		public:
+			using promise_type = Detail::TaskPromise<T>;
+		private:
+			std::coroutine_handle<promise_type> _Handle;
+		public:
+			Task()
+				: _Handle(nullptr)
+			{
+			}
+			explicit Task(std::coroutine_handle<promise_type> handle)
+				: _Handle(handle)
+			{
+			}
+			Task(const Task&) = delete;
+			Task(Task&& instance)
+				: _Handle(nullptr)
+			{
+				std::swap(_Handle, instance._Handle);
+			}
+			~Task()
+			{
+				if (_Handle)
+					_Handle.destroy();
+			}
+
+			Task& operator=(const Task&) = delete;
+			Task& operator=(Task&& instance)
+			{
+				std::swap(_Handle, instance._Handle);
+				return *this;
+			}
+
+			bool await_ready() const
+			{
+				// Default-constructed or moved from; there is no result to resume with.
+				if (!_Handle)
+					throw std::logic_error("Awaiting an empty task.");
+				return _Handle.done();
+			}
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+			{
+				_Handle.promise()._Continuation = awaiting;
+				return _Handle;
+			}
+			T await_resume()
+			{
+				return _Handle.promise().Result();
+			}
+		};
+
+		namespace Detail
+		{
+			template<typename T>
+			Task<T> TaskPromise<T>::get_return_object()
+			{
+				return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+			}
+			inline Task<void> TaskPromise<void>::get_return_object()
+			{
+				return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+			}
+
+			// The frame of a spawned task. It destroys itself when done.
+			struct DetachedTask
+			{
+				struct promise_type
+				{
+					DetachedTask get_return_object()
+					{
+						return { std::coroutine_handle<promise_type>::from_promise(*this) };
+					}
+					std::suspend_always initial_suspend() noexcept { return {}; }
+					std::suspend_never final_suspend() noexcept { return {}; }
+					void return_void() {}
+					// A failed connection handler must not take the whole loop down, so the error is reported instead.
+					void unhandled_exception();
+				};
+
+				std::coroutine_handle<promise_type> Handle;
+			};
+			DetachedTask RunDetached(Task<void> task);
+		}
+
+		/*
+		 * Start $task on $loop without waiting for it.
+		 */
+		void Spawn(EventLoop& loop, Task<void> task);
+
+		/*
+		 * Base of socket awaiters. The operation is tried at once and only suspends if the socket would block; the coroutine is then resumed on the current loop thread.
+		 * [note] A socket can have only one pending operation at a time.
+		 */
+		class SocketAwaiter
+			: public IoWaiter
+		{
+		private:
+			EventLoop& _Loop;
+			std::coroutine_handle<> _Awaiting;
+			uint32_t _AwaitEvents;
+		protected:
+			Socket& _Socket;
+			std::exception_ptr _Error;
+
+			SocketAwaiter(Socket& socket, uint32_t events);
+
+			/*
+			 * Try to carry out the operation without blocking.
+			 * [return] False if the socket would block.
+			 */
+			virtual bool Perform() = 0;
+			void Rethrow();
+		public:
+			bool OnReady() override;
+			void OnError(std::exception_ptr error) override;
+
+			bool await_ready();
+			void await_suspend(std::coroutine_handle<> awaiting);
+		};
+
+		class ReceiveAwaiter
+			: public SocketAwaiter
+		{
+		private:
+			Byte* _Data;
+			size_t _Length;
+			long _Received;
+		protected:
+			bool Perform() override;
+		public:
+			ReceiveAwaiter(Socket& socket, Byte* data, size_t length);
+
+			/* [return] The number of bytes received, 0 if the peer has closed the connection. */
+			size_t await_resume();
+		};
+
+		class SendAwaiter
+			: public SocketAwaiter
+		{
+		private:
+			const Byte* _Data;
+			size_t _Length;
+			size_t _Sent;
+		protected:
+			bool Perform() override;
+		public:
+			SendAwaiter(Socket& socket, const Byte* data, size_t length);
+
+			/* [return] The number of bytes sent, which is always the full length. */
+			size_t await_resume();
+		};
+
+		class SendFileAwaiter
+			: public SocketAwaiter
+		{
+		private:
+			int _Fd;
+			size_t _Offset;
+			size_t _Count;
+			size_t _Sent;
+		protected:
+			bool Perform() override;
+		public:
+			SendFileAwaiter(Socket& socket, int fd, size_t offset, size_t count);
+
+			/* [return] The number of bytes sent, which is always $count. */
+			size_t await_resume();
+		};
+
+		class AcceptAwaiter
+			: public SocketAwaiter
+		{
+		private:
+			SocketAddress& _Peer;
+			Socket _Accepted;
+		protected:
+			bool Perform() override;
+		public:
+			AcceptAwaiter(Socket& listener, SocketAddress& peer);
+
+			/* [return] The accepted connection, already non-blocking. */
+			Socket await_resume();
+		};
+
+		class ConnectAwaiter
+			: public SocketAwaiter
+		{
+		private:
+			const SocketAddress& _Addr;
+			bool _IsStarted;
+		protected:
+			bool Perform() override;
+		public:
+			ConnectAwaiter(Socket& socket, const SocketAddress& addr);
+
+			void await_resume();
+		};
+
+		/*
+		 * [note] The socket should be non-blocking (Socket::SetBlocking(false)) and the coroutine running on an event loop.
+		 */
+		ReceiveAwaiter ReceiveAsync(Socket& socket, Buffer& buffer);
+		ReceiveAwaiter ReceiveAsync(Socket& socket, Byte* data, size_t length);
+		SendAwaiter SendAsync(Socket& socket, const Buffer& buffer);
+		SendAwaiter SendAsync(Socket& socket, const Byte* data, size_t length);
+		/*
+		 * Send $count bytes of the open file $fd from $offset with Socket::TrySendFile(), i.e. sendfile(2).
+		 */
+		SendFileAwaiter SendFileAsync(Socket& socket, int fd, size_t offset, size_t count);
+		AcceptAwaiter AcceptAsync(Socket& listener, SocketAddress& peer);
+		ConnectAwaiter ConnectAsync(Socket& socket, const SocketAddress& addr);
+	}
+}
+#endif // _L_LINUX && __cpp_impl_coroutine
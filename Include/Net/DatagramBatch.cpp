@@ -0,0 +1,76 @@
+// File: DatagramBatch.cpp
+// Author: Rendong Liang (Liong)
+#include "DatagramBatch.hpp"
+
+namespace LiongPlus
+{
+	namespace Net
+	{
+		DatagramBatch::DatagramBatch(size_t capacity, size_t messageLength)
+			: _Buffers()
+			, _Lengths(capacity, 0)
+			, _Addrs(capacity)
+			, _AddrLengths(capacity, 0)
+#ifdef _L_LINUX
+			, _Vectors(capacity)
+			, _Headers(capacity)
+#endif
+		{
+			_Buffers.reserve(capacity);
+			for (size_t i = 0; i < capacity; ++i)
+				_Buffers.emplace_back(messageLength);
+
+#ifdef _L_LINUX
+			// The headers point into the vectors above, which never reallocate, so they are wired up once here.
+			for (size_t i = 0; i < capacity; ++i)
+			{
+				_Vectors[i].iov_base = _Buffers[i].Field();
+				_Vectors[i].iov_len = messageLength;
+				memset(&_Headers[i], 0, sizeof(mmsghdr));
+				_Headers[i].msg_hdr.msg_name = &_Addrs[i];
+				_Headers[i].msg_hdr.msg_iov = &_Vectors[i];
+				_Headers[i].msg_hdr.msg_iovlen = 1;
+			}
+#endif
+		}
+
+		size_t DatagramBatch::Capacity() const
+		{
+			return _Buffers.size();
+		}
+
+		Buffer& DatagramBatch::Data(size_t index)
+		{
+			return _Buffers[index];
+		}
+		const Buffer& DatagramBatch::Data(size_t index) const
+		{
+			return _Buffers[index];
+		}
+
+		size_t& DatagramBatch::Length(size_t index)
+		{
+			return _Lengths[index];
+		}
+		size_t DatagramBatch::Length(size_t index) const
+		{
+			return _Lengths[index];
+		}
+
+		void DatagramBatch::SetAddress(size_t index, const SocketAddress& addr)
+		{
+			if (addr.Length() > sizeof(sockaddr_storage))
+				throw std::runtime_error("$addr is too long.");
+			memcpy(&_Addrs[index], addr.Field(), addr.Length());
+			_AddrLengths[index] = addr.Length();
+		}
+		const sockaddr* DatagramBatch::Address(size_t index) const
+		{
+			return reinterpret_cast<const sockaddr*>(&_Addrs[index]);
+		}
+		size_t DatagramBatch::AddressLength(size_t index) const
+		{
+			return _AddrLengths[index];
+		}
+	}
+}
@@ -0,0 +1,53 @@
+// File: DatagramBatch.hpp
+// Author: Rendong Liang (Liong)
+
+#pragma once
+#include "../Fundamental.hpp"
+#include "../Buffer.hpp"
+#include "SocketAddress.hpp"
+
+namespace LiongPlus
+{
+	namespace Net
+	{
+		/*
+		 * A fixed set of datagram slots for Socket::SendBatch and Socket::ReceiveBatch. Payload buffers and peer addresses are allocated once up front and reused by every call, so moving a batch costs no allocation.
+		 */
+		class DatagramBatch
+		{
+			friend class Socket;
+		private:
+			std::vector<Buffer> _Buffers;
+			std::vector<size_t> _Lengths;
+			std::vector<sockaddr_storage> _Addrs;
+			std::vector<socklen_t> _AddrLengths;
+#ifdef _L_LINUX
+			std::vector<iovec> _Vectors;
+			std::vector<mmsghdr> _Headers;
+#endif
+		public:
+			/*
+			 * Allocate $capacity slots, each able to hold a datagram of at most $messageLength bytes.
+			 */
+			DatagramBatch(size_t capacity, size_t messageLength);
+			DatagramBatch(const DatagramBatch&) = delete;
+			DatagramBatch(DatagramBatch&&) = default;
+
+			DatagramBatch& operator=(DatagramBatch&&) = default;
+
+			size_t Capacity() const;
+
+			/* The payload storage of slot $index. */
+			Buffer& Data(size_t index);
+			const Buffer& Data(size_t index) const;
+			/* The number of meaningful bytes in slot $index, at most the length of Data($index). Set it before sending; it is filled in by receiving. */
+			size_t& Length(size_t index);
+			size_t Length(size_t index) const;
+
+			/* The peer address of slot $index. Set it before sending; it is filled in by receiving. */
+			void SetAddress(size_t index, const SocketAddress& addr);
+			const sockaddr* Address(size_t index) const;
+			size_t AddressLength(size_t index) const;
+		};
+	}
+}
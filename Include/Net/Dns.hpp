@@ -1,6 +1,8 @@
 // File: Dns.hpp
 // Author: Rendong Liang (Liong)
+#pragma once
 #include "../Fundamental.hpp"
+#include "Resolver.hpp"
 #include "SocketAddress.hpp"
 
 namespace LiongPlus
@@ -11,22 +13,39 @@ namespace LiongPlus
 		class Dns
 		{
 		public:
+			/*
+			 * Resolve $name through [LiongPlus::Net::Resolver::Default], so repeated queries are served from its cache.
+			 */
 			static vector<IPv4EndPoint> GetHostIPv4(const string name)
 			{
 				vector<IPv4EndPoint> addrs;
-				DNS_RECORD* recordList;
-				if (DnsQuery_UTF8(name.c_str(), DNS_TYPE_A, DNS_QUERY_STANDARD, NULL, &recordList, NULL) != 0)
+				for (auto& addr : Resolver::Default().Resolve(name))
+				{
+					if (addr.AddressFamily() == AF_INET)
+						addrs.push_back(IPv4EndPoint(reinterpret_cast<const uint8_t*>(addr.Field() + 4), 0));
+				}
+				if (addrs.empty())
 					throw runtime_error("Failed in getting host address in IPv4.");
-				
-				auto record = recordList;
-				while (record != nullptr)
+				return addrs;
+			}
+			static vector<IPv6EndPoint> GetHostIPv6(const string name)
+			{
+				vector<IPv6EndPoint> addrs;
+				for (auto& addr : Resolver::Default().Resolve(name))
 				{
-					addrs.push_back(IPv4EndPoint(reinterpret_cast<uint8_t*>(&(record->Data.A)), 0));
-					record = record->pNext;
+					if (addr.AddressFamily() == AF_INET6)
+					{
+						// $addr is a plain SocketAddress, so it is rebuilt rather than cast down.
+						auto& raw = *reinterpret_cast<const sockaddr_in6*>(addr.Field());
+						IPv6EndPoint endPoint(reinterpret_cast<const uint8_t*>(&raw.sin6_addr), 0);
+						endPoint.ScopeId() = raw.sin6_scope_id;
+						addrs.push_back(endPoint);
+					}
 				}
-				DnsRecordListFree(record, DnsRecordList);
+				if (addrs.empty())
+					throw runtime_error("Failed in getting host address in IPv6.");
 				return addrs;
 			}
 		};
 	}
-}
\ No newline at end of file
+}
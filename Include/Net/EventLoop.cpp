@@ -0,0 +1,263 @@
+// File: EventLoop.cpp
+// Author: Rendong Liang (Liong)
+#include "EventLoop.hpp"
+#include "../Diagnostics/AsyncLogger.hpp"
+
+#ifdef _L_LINUX
+namespace LiongPlus
+{
+	namespace Net
+	{
+		using std::swap;
+
+		static thread_local EventLoop* _CurrentLoop = nullptr;
+
+		namespace Detail
+		{
+			void ReportError(const char* context, std::exception_ptr error)
+			{
+				std::string message;
+				try
+				{
+					std::rethrow_exception(error);
+				}
+				catch (const std::exception& e)
+				{
+					message = e.what();
+				}
+				catch (...)
+				{
+					message = "unknown exception";
+				}
+				// Errors are rare and must not go unnoticed, so they do not depend on a logger being installed.
+				if (Diagnostics::AsyncLogger::Default() != nullptr)
+					_L_Log_Error("{}: {}", context, message);
+				else
+					fprintf(stderr, "%s: %s\n", context, message.c_str());
+			}
+		}
+
+		IoWaiter::IoWaiter()
+			: _Handle(-1)
+			, _Events(0)
+		{
+		}
+		IoWaiter::~IoWaiter()
+		{
+		}
+
+		void IoWaiter::OnError(std::exception_ptr error)
+		{
+			Detail::ReportError("Event loop dropped a waiter", error);
+		}
+
+
+
+		EventLoop::EventLoop()
+			: _HPoll(epoll_create1(EPOLL_CLOEXEC))
+			, _HWake(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+			, _ShouldExit(false)
+			, _Mutex()
+			, _Posted()
+		{
+			if (_HPoll < 0 || _HWake < 0)
+				throw std::runtime_error("Failed in creating event loop.");
+
+			epoll_event ev = {};
+			ev.events = EPOLLIN;
+			ev.data.ptr = nullptr; // The wake-up handle is the only one without a waiter.
+			if (epoll_ctl(_HPoll, EPOLL_CTL_ADD, _HWake, &ev) < 0)
+				throw std::runtime_error("Failed in creating event loop.");
+		}
+		EventLoop::~EventLoop()
+		{
+			// Destroyed here rather than with the members, so that whatever they own is released while the loop is still whole.
+			_Posted.clear();
+			close(_HWake);
+			close(_HPoll);
+		}
+
+		void EventLoop::Watch(const Socket& socket, uint32_t events, IoWaiter* waiter)
+		{
+			Watch(socket.Handle(), events, waiter);
+		}
+		void EventLoop::Watch(Socket::HSocket handle, uint32_t events, IoWaiter* waiter)
+		{
+			waiter->_Handle = handle;
+			waiter->_Events = events;
+			Arm(waiter);
+		}
+
+		void EventLoop::Post(Action<> action)
+		{
+			_Mutex.lock();
+			_Posted.push_back(std::move(action));
+			_Mutex.unlock();
+
+			Wake();
+		}
+
+		void EventLoop::Run()
+		{
+			auto last = _CurrentLoop;
+			_CurrentLoop = this;
+
+			epoll_event events[MAX_EVENT_COUNT];
+			while (!_ShouldExit.load(std::memory_order_acquire))
+			{
+				int count = epoll_wait(_HPoll, events, MAX_EVENT_COUNT, -1);
+				if (count < 0)
+				{
+					if (errno == EINTR)
+						continue;
+					_CurrentLoop = last;
+					throw std::runtime_error("Failed in waiting for events.");
+				}
+
+				for (int i = 0; i < count; ++i)
+				{
+					auto waiter = static_cast<IoWaiter*>(events[i].data.ptr);
+					if (waiter == nullptr)
+					{
+						// EAGAIN if an earlier pass drained the counter already.
+						uint64_t count;
+						if (read(_HWake, &count, sizeof(count)) < 0 && errno != EAGAIN && errno != EINTR)
+						{
+							_CurrentLoop = last;
+							throw std::runtime_error("Failed in reading wake-up event.");
+						}
+						RunPosted();
+						continue;
+					}
+					// A failing waiter must not take the loop, and every other waiter on it, down.
+					try
+					{
+						if (!waiter->OnReady())
+							Arm(waiter);
+					}
+					catch (...)
+					{
+						waiter->OnError(std::current_exception());
+					}
+				}
+			}
+
+			_CurrentLoop = last;
+		}
+
+		void EventLoop::Stop()
+		{
+			_ShouldExit.store(true, std::memory_order_release);
+			Wake();
+		}
+
+		EventLoop* EventLoop::Current()
+		{
+			return _CurrentLoop;
+		}
+
+		// Private
+
+		void EventLoop::Arm(IoWaiter* waiter)
+		{
+			epoll_event ev = {};
+			ev.events = waiter->_Events | EPOLLONESHOT;
+			ev.data.ptr = waiter;
+			// One-shot registrations stay in the set once fired, so MOD is the usual case. A closed handle leaves the set on its own and the number might come back as a new socket, thus fall back to ADD.
+			if (epoll_ctl(_HPoll, EPOLL_CTL_MOD, waiter->_Handle, &ev) < 0)
+			{
+				if (errno != ENOENT || epoll_ctl(_HPoll, EPOLL_CTL_ADD, waiter->_Handle, &ev) < 0)
+					throw std::runtime_error("Failed in watching socket.");
+			}
+		}
+
+		void EventLoop::Wake()
+		{
+			uint64_t one = 1;
+			while (write(_HWake, &one, sizeof(one)) < 0)
+			{
+				// The counter is saturated, so a wake-up is pending anyway.
+				if (errno == EAGAIN)
+					return;
+				if (errno != EINTR)
+					throw std::runtime_error("Failed in waking event loop.");
+			}
+		}
+
+		void EventLoop::RunPosted()
+		{
+			std::vector<Action<>> posted;
+			_Mutex.lock();
+			swap(posted, _Posted);
+			_Mutex.unlock();
+
+			for (auto& action : posted)
+			{
+				try
+				{
+					action();
+				}
+				catch (...)
+				{
+					Detail::ReportError("Event loop dropped a failed action", std::current_exception());
+				}
+			}
+		}
+
+
+
+		Scheduler::Scheduler()
+			: Scheduler(std::max(std::thread::hardware_concurrency(), 1u))
+		{
+		}
+		Scheduler::Scheduler(size_t count)
+			: _Loops()
+			, _Threads()
+			, _Next(0)
+		{
+			size_t coreCount = std::max(std::thread::hardware_concurrency(), 1u);
+			for (size_t i = 0; i < count; ++i)
+				_Loops.emplace_back(new EventLoop());
+			for (size_t i = 0; i < count; ++i)
+			{
+				auto loop = _Loops[i].get();
+				_Threads.emplace_back([loop] { loop->Run(); });
+
+				cpu_set_t cpus;
+				CPU_ZERO(&cpus);
+				CPU_SET(i % coreCount, &cpus);
+				// Pinning is a hint. Failure (e.g. restricted affinity in containers) leaves the thread floating.
+				pthread_setaffinity_np(_Threads.back().native_handle(), sizeof(cpus), &cpus);
+			}
+		}
+		Scheduler::~Scheduler()
+		{
+			for (auto& loop : _Loops)
+				loop->Stop();
+			for (auto& thread : _Threads)
+				thread.join();
+		}
+
+		EventLoop& Scheduler::operator[](size_t index)
+		{
+			return *_Loops[index];
+		}
+
+		size_t Scheduler::Count() const
+		{
+			return _Loops.size();
+		}
+
+		EventLoop& Scheduler::Next()
+		{
+			return *_Loops[_Next.fetch_add(1, std::memory_order_relaxed) % _Loops.size()];
+		}
+
+		Scheduler& Scheduler::Default()
+		{
+			static Scheduler scheduler;
+			return scheduler;
+		}
+	}
+}
+#endif // _L_LINUX
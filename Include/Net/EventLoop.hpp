@@ -0,0 +1,123 @@
+// File: EventLoop.hpp
+// Author: Rendong Liang (Liong)
+
+#pragma once
+#include "../Fundamental.hpp"
+#include "Socket.hpp"
+
+#ifdef _L_LINUX
+namespace LiongPlus
+{
+	namespace Net
+	{
+		/*
+		 * Something waiting for a socket to become ready. The waiter is owned by the caller and must outlive the wait.
+		 */
+		class IoWaiter
+		{
+			friend class EventLoop;
+		private:
+			Socket::HSocket _Handle;
+			uint32_t _Events;
+		public:
+			IoWaiter();
+			virtual ~IoWaiter();
+
+			/*
+			 * Called on the loop thread once the watched socket is ready.
+			 * [return] True if the waiter is satisfied. False to re-arm and wait again.
+			 * [note] When true is returned the loop never touches the waiter again, so the waiter may be destroyed inside.
+			 */
+			virtual bool OnReady() = 0;
+			/*
+			 * Called on the loop thread instead of waiting again if OnReady() throws or the waiter cannot be re-armed, e.g. because its socket was closed meanwhile. The loop never touches the waiter again.
+			 * The default reports $error through Detail::ReportError().
+			 */
+			virtual void OnError(std::exception_ptr error);
+		};
+
+		namespace Detail
+		{
+			/*
+			 * Log $error, which no caller is left to handle, through the default logger, or to stderr if none is installed.
+			 */
+			void ReportError(const char* context, std::exception_ptr error);
+		}
+
+		/*
+		 * A single-threaded epoll loop. Sockets are watched one-shot, so a socket has at most one waiter at a time.
+		 */
+		class EventLoop
+		{
+		private:
+			static const int MAX_EVENT_COUNT = 64;
+
+			int _HPoll;
+			int _HWake;
+			std::atomic<bool> _ShouldExit;
+			std::mutex _Mutex;
+			std::vector<Action<>> _Posted;
+
+			void Arm(IoWaiter* waiter);
+			void Wake();
+			void RunPosted();
+		public:
+			EventLoop();
+			EventLoop(const EventLoop&) = delete;
+			EventLoop(EventLoop&&) = delete;
+			~EventLoop();
+
+			/*
+			 * Wait until $socket is ready for $events (EPOLLIN, EPOLLOUT) and then notify $waiter on the loop thread.
+			 */
+			void Watch(const Socket& socket, uint32_t events, IoWaiter* waiter);
+			/*
+			 * Wait until $handle, any descriptor epoll accepts (e.g. a timerfd), is ready for $events.
+			 */
+			void Watch(Socket::HSocket handle, uint32_t events, IoWaiter* waiter);
+			/*
+			 * Run $action on the loop thread. Can be called from any thread. An exception thrown by $action is reported and does not stop the loop.
+			 * Actions still pending when the loop is destroyed are destroyed without being run.
+			 */
+			void Post(Action<> action);
+			/*
+			 * Dispatch events on the calling thread until Stop() is called. A failing waiter is handed its error through IoWaiter::OnError() and does not stop the loop.
+			 */
+			void Run();
+			void Stop();
+
+			/*
+			 * [return] The loop running on the calling thread, or nullptr if there is none.
+			 */
+			static EventLoop* Current();
+		};
+
+		/*
+		 * A set of event loops, one thread per loop, each thread pinned to its own core.
+		 */
+		class Scheduler
+		{
+		private:
+			std::vector<std::unique_ptr<EventLoop>> _Loops;
+			std::vector<std::thread> _Threads;
+			std::atomic<size_t> _Next;
+		public:
+			Scheduler();
+			Scheduler(size_t count);
+			Scheduler(const Scheduler&) = delete;
+			Scheduler(Scheduler&&) = delete;
+			~Scheduler();
+
+			EventLoop& operator[](size_t index);
+
+			size_t Count() const;
+			/*
+			 * [return] The next loop in round-robin order.
+			 */
+			EventLoop& Next();
+
+			static Scheduler& Default();
+		};
+	}
+}
+#endif // _L_LINUX
@@ -0,0 +1,83 @@
+// File: HttpClient.cpp
+// Author: Rendong Liang (Liong)
+#include "HttpClient.hpp"
+#include "../Diagnostics/Metrics.hpp"
+
+#ifdef _L_COROUTINE
+namespace LiongPlus
+{
+	namespace Net
+	{
+		using std::swap;
+
+		HttpClient::HttpClient(const SocketAddress& addr)
+			: _Socket(addr.AddressFamily(), SOCK_STREAM, IPPROTO_TCP)
+			, _Addr(addr)
+			, _IsConnected(false)
+			, _SentAt()
+		{
+			_Socket.SetBlocking(false);
+		}
+		HttpClient::HttpClient(HttpClient&& instance)
+			: _Socket()
+			, _Addr()
+			, _IsConnected(false)
+			, _SentAt()
+		{
+			swap(_Socket, instance._Socket);
+			swap(_Addr, instance._Addr);
+			swap(_IsConnected, instance._IsConnected);
+			swap(_SentAt, instance._SentAt);
+		}
+
+		HttpClient& HttpClient::operator=(HttpClient&& instance)
+		{
+			swap(_Socket, instance._Socket);
+			swap(_Addr, instance._Addr);
+			swap(_IsConnected, instance._IsConnected);
+			swap(_SentAt, instance._SentAt);
+			return *this;
+		}
+
+		const SocketAddress& HttpClient::BaseAddress() const
+		{
+			return _Addr;
+		}
+
+		bool HttpClient::IsConnected() const
+		{
+			return _IsConnected;
+		}
+
+		Task<void> HttpClient::ConnectAsync()
+		{
+			if (!_IsConnected)
+			{
+				co_await Net::ConnectAsync(_Socket, _Addr);
+				_IsConnected = true;
+			}
+		}
+
+		Task<void> HttpClient::SendAsync(const HttpRequest& request)
+		{
+			if (!_IsConnected)
+				co_await ConnectAsync();
+			auto data = request.ToBuffer();
+			co_await Net::SendAsync(_Socket, data);
+			_SentAt = std::chrono::steady_clock::now();
+		}
+
+		Task<size_t> HttpClient::ReceiveAsync(Buffer& buffer)
+		{
+			static auto& latency = Diagnostics::MetricsRegistry::Default().GetHistogram("liong_http_client_request_seconds", "Time from sending a request to the first byte of its response.", 1e-9);
+			auto received = co_await Net::ReceiveAsync(_Socket, buffer);
+			if (received != 0 && _SentAt != std::chrono::steady_clock::time_point())
+			{
+				latency.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _SentAt).count());
+				_SentAt = std::chrono::steady_clock::time_point();
+			}
+			co_return received;
+		}
+	}
+}
+#endif // _L_COROUTINE
@@ -1,50 +1,48 @@
-/*// File: HttpClient.hpp
+// File: HttpClient.hpp
 // Author: Rendong Liang (Liong)
+#pragma once
 #include "../Fundamental.hpp"
+#include "Async.hpp"
+#include "HttpMessage.hpp"
 #include "Socket.hpp"
 
+#ifdef _L_COROUTINE
 namespace LiongPlus
 {
 	namespace Net
 	{
-		using namespace std;
-		using std::swap;
-
+		/*
+		 * A keep-alive HTTP connection driven by coroutines. Must be used from a coroutine running on an [LiongPlus::Net::EventLoop].
+		 */
 		class HttpClient
 		{
+		private:
 			Socket _Socket;
 			SocketAddress _Addr;
 			bool _IsConnected;
-
-			HttpClient(SocketAddress& addr)
-				: _Socket(AF_INET, SOCK_STREAM, IPPROTO_TCP)
-				, _Addr(addr)
-				, _IsConnected(false)
-			{
-			}
+			// When the last request was sent, or zero once its response has started arriving.
+			std::chrono::steady_clock::time_point _SentAt;
+		public:
+			HttpClient(const SocketAddress& addr);
 			HttpClient(const HttpClient&) = delete;
-			HttpClient(HttpClient&& instance)
-				: _Socket()
-				, _Addr()
-				, _IsConnected(false)
-			{
-				swap(_Socket, instance._Socket);
-				swap(_Addr, instance._Addr);
-				swap(_IsConnected, instance._IsConnected);
-			}
+			HttpClient(HttpClient&& instance);
+
+			HttpClient& operator=(HttpClient&& instance);
+
+			const SocketAddress& BaseAddress() const;
+			bool IsConnected() const;
 
-			string& BaseAddress()
-			{
-				return _BaseAddr;
-			}
-			void SendRequest()
-			{
-				_Socket.Send();
-			}
-			void SendRequestAsync()
-			{
-				async(launch::async, );
-			}
+			Task<void> ConnectAsync();
+			/*
+			 * Send $request, connecting first if necessary.
+			 */
+			Task<void> SendAsync(const HttpRequest& request);
+			/*
+			 * Receive raw response data into $buffer. The time from the last request to the first response data is recorded as request latency in the default metrics registry.
+			 * [return] The number of bytes received, 0 if the server has closed the connection.
+			 */
+			Task<size_t> ReceiveAsync(Buffer& buffer);
 		};
 	}
-}*/
\ No newline at end of file
+}
+#endif // _L_COROUTINE
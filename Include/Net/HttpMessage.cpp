@@ -2,6 +2,7 @@
 // Author: Rendong Liang (Liong)
 #include "HttpMessage.hpp"
 #include "../IO/MemoryStream.hpp"
+#include "../Diagnostics/Trace.hpp"
 
 namespace LiongPlus
 {
@@ -79,6 +80,7 @@ namespace LiongPlus
 		{
 			swap(MajorVersion, instance.MajorVersion);
 			swap(MinorVersion, instance.MinorVersion);
+			swap(StatusCode, instance.StatusCode);
 			swap(Status, instance.Status);
 		}
 		HttpStatusLine::HttpStatusLine(long major, long minor, long statusCode, string status)
@@ -93,6 +95,7 @@ namespace LiongPlus
 		{
 			MajorVersion = instance.MajorVersion;
 			MinorVersion = instance.MinorVersion;
+			StatusCode = instance.StatusCode;
 			Status = instance.Status;
 			return *this;
 		}
@@ -100,6 +103,7 @@ namespace LiongPlus
 		{
 			swap(MajorVersion, instance.MajorVersion);
 			swap(MinorVersion, instance.MinorVersion);
+			swap(StatusCode, instance.StatusCode);
 			swap(Status, instance.Status);
 			return *this;
 		}
@@ -107,7 +111,7 @@ namespace LiongPlus
 		string HttpStatusLine::ToString() const
 		{
 			stringstream ss;
-			ss << "HTTP/" << MajorVersion << '.' << MinorVersion << ' ' << Status << '\n';
+			ss << "HTTP/" << MajorVersion << '.' << MinorVersion << ' ' << StatusCode << ' ' << Status << '\n';
 			return ss.str();
 		}
 
@@ -216,14 +220,15 @@ namespace LiongPlus
 		// HttpRequest
 		//
 
-		HttpMessage::HttpMessage(HttpHeader header, Buffer content)
+		HttpMessage::HttpMessage(HttpHeader header, SharedBuffer content)
 			: Header(header)
-			, Content(content)
+			, Content(std::move(content))
 		{
 		}
 
-		Buffer HttpMessage::ToBuffer(const HttpLine& _line, const HttpHeader& _header, const Buffer& _content)
+		Buffer HttpMessage::ToBuffer(const HttpLine& _line, const HttpHeader& _header, const SharedBuffer& _content)
 		{
+			_L_Trace_Span("http", "HttpMessage::ToBuffer");
 			string line = _line.ToString();
 			string header = _header.ToString();
 
@@ -231,7 +236,9 @@ namespace LiongPlus
 			memcpy(buffer.Field(), line.c_str(), line.length());
 			memcpy(buffer.Field() + line.length(), header.c_str(), header.length());
 			buffer.Field()[line.length() + header.length()] = '\n';
-			memcpy(buffer.Field() + line.length() + header.length() + 1, _content.Field(), _content.Length());
+			// An empty body has no bytes at all, and memcpy must not be given a null source even for zero of them.
+			if (_content.Length() > 0)
+				memcpy(buffer.Field() + line.length() + header.length() + 1, _content.Field(), _content.Length());
 			return buffer;
 		}
 
@@ -240,7 +247,12 @@ namespace LiongPlus
 		//
 
 		HttpRequest::HttpRequest(HttpHeader& header, HttpRequestLine& line, Buffer& content)
-			: HttpMessage(header, content)
+			: HttpMessage(header, content.Clone())
+			, RequestLine(line)
+		{
+		}
+		HttpRequest::HttpRequest(HttpHeader& header, HttpRequestLine& line, SharedBuffer content)
+			: HttpMessage(header, std::move(content))
 			, RequestLine(line)
 		{
 		}
@@ -255,7 +267,12 @@ namespace LiongPlus
 		//
 
 		HttpResponse::HttpResponse(HttpHeader& header, HttpStatusLine& line, Buffer& content)
-			: HttpMessage(header, content)
+			: HttpMessage(header, content.Clone())
+			, StatusLine(line)
+		{
+		}
+		HttpResponse::HttpResponse(HttpHeader& header, HttpStatusLine& line, SharedBuffer content)
+			: HttpMessage(header, std::move(content))
 			, StatusLine(line)
 		{
 		}
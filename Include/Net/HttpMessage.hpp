@@ -3,6 +3,7 @@
 #pragma once
 #include "../Fundamental.hpp"
 #include "../Buffer.hpp"
+#include "../SharedBuffer.hpp"
 #include "Socket.hpp"
 
 namespace LiongPlus
@@ -159,12 +160,13 @@ namespace LiongPlus
 		struct HttpMessage
 		{
 		protected:
-			HttpMessage(HttpHeader header, Buffer content);
+			HttpMessage(HttpHeader header, SharedBuffer content);
 
-			static Buffer ToBuffer(const HttpLine& _line, const HttpHeader& _header, const Buffer& _content);
+			static Buffer ToBuffer(const HttpLine& _line, const HttpHeader& _header, const SharedBuffer& _content);
 		public:
 			HttpHeader Header;
-			Buffer Content;
+			// Shared with copies of the message, so the same body can go out on many connections.
+			SharedBuffer Content;
 
 			virtual Buffer ToBuffer() const = 0;
 		};
@@ -176,6 +178,7 @@ namespace LiongPlus
 			HttpRequestLine RequestLine;
 
 			HttpRequest(HttpHeader& header, HttpRequestLine& line, Buffer& Content);
+			HttpRequest(HttpHeader& header, HttpRequestLine& line, SharedBuffer content);
 
 			Buffer ToBuffer() const override;
 		};
@@ -186,7 +189,11 @@ namespace LiongPlus
 		public:
 			HttpStatusLine StatusLine;
 
+			/*
+			 * Copies $content; pass a SharedBuffer to avoid that.
+			 */
 			HttpResponse(HttpHeader& header, HttpStatusLine& line, Buffer& content);
+			HttpResponse(HttpHeader& header, HttpStatusLine& line, SharedBuffer content);
 
 			Buffer ToBuffer() const override;
 			
@@ -0,0 +1,188 @@
+// File: Ping.cpp
+// Author: Rendong Liang (Liong)
+#include "Ping.hpp"
+
+#ifndef _L_WINDOWS
+namespace LiongPlus
+{
+	namespace Net
+	{
+		using namespace std;
+
+		static const size_t PACKET_LENGTH = 20;
+		static const size_t REPLY_BUFFER_LENGTH = 128;
+		static const uint8_t ICMP_ECHO_REPLY = 0, ICMP_ECHO_REQUEST = 8;
+
+		static uint16_t Checksum(const Byte* data, size_t length)
+		{
+			uint32_t sum = 0;
+			for (size_t i = 0; i + 1 < length; i += 2)
+				sum += *((const uint16_t*)(data + i));
+			if (length & 1)
+				sum += (uint8_t)data[length - 1];
+			while (sum >> 16)
+				sum = (sum & 0xFFFF) + (sum >> 16);
+			return (uint16_t)~sum;
+		}
+
+		Ping::Ping()
+			: _Socket()
+			, _IsRaw(false)
+			, _Id((uint16_t)getpid())
+			, _Generation((uint32_t)chrono::steady_clock::now().time_since_epoch().count())
+		{
+			try
+			{
+				_Socket = Socket(AF_INET, SOCK_DGRAM, IPPROTO_ICMP);
+			}
+			catch (const runtime_error&)
+			{
+				_Socket = Socket(AF_INET, SOCK_RAW, IPPROTO_ICMP);
+				_IsRaw = true;
+			}
+		}
+
+		vector<Ping::Statistics> Ping::Sweep(const vector<SocketAddress>& targets, long count, long interval, long timeout)
+		{
+			++_Generation;
+			vector<Probe> probes(targets.size() * count);
+			Buffer packet(PACKET_LENGTH);
+			long pending = 0;
+			auto start = chrono::steady_clock::now();
+
+			for (long round = 0; round < count; ++round)
+			{
+				auto roundStart = start + chrono::milliseconds(interval * round);
+				for (auto now = chrono::steady_clock::now(); now < roundStart; now = chrono::steady_clock::now())
+					ReceiveReplies(probes, (long)chrono::duration_cast<chrono::milliseconds>(roundStart - now).count() + 1, pending);
+
+				for (size_t target = 0; target < targets.size(); ++target)
+				{
+					uint32_t index = (uint32_t)(round * targets.size() + target);
+					auto& probe = probes[index];
+					probe.Target = target;
+					probe.IsAnswered = false;
+					probe.SentAt = chrono::steady_clock::now();
+					if (SendProbe(targets[target], index, packet))
+						++pending;
+					// Drain now and then so that a large sweep does not overflow the receive buffer.
+					if ((index & 0x3F) == 0x3F)
+						ReceiveReplies(probes, 0, pending);
+				}
+			}
+
+			auto deadline = chrono::steady_clock::now() + chrono::milliseconds(timeout);
+			for (auto now = chrono::steady_clock::now(); pending > 0 && now < deadline; now = chrono::steady_clock::now())
+				ReceiveReplies(probes, (long)chrono::duration_cast<chrono::milliseconds>(deadline - now).count() + 1, pending);
+
+			vector<vector<double>> rtts(targets.size());
+			for (auto& probe : probes)
+			{
+				if (probe.IsAnswered)
+					rtts[probe.Target].push_back(probe.Rtt);
+			}
+
+			vector<Statistics> stats(targets.size());
+			for (size_t target = 0; target < targets.size(); ++target)
+			{
+				auto& samples = rtts[target];
+				auto& stat = stats[target];
+				stat.Sent = count;
+				stat.Received = (long)samples.size();
+				stat.Lost = count - stat.Received;
+				stat.MinRtt = stat.AverageRtt = stat.P99Rtt = 0;
+				if (samples.empty())
+					continue;
+
+				sort(samples.begin(), samples.end());
+				stat.MinRtt = samples.front();
+				for (auto rtt : samples)
+					stat.AverageRtt += rtt;
+				stat.AverageRtt /= samples.size();
+				stat.P99Rtt = samples[(size_t)ceil(samples.size() * 0.99) - 1];
+			}
+			return stats;
+		}
+
+		tuple<double, long> Ping::MakePing(SocketAddress& addr, long count, long timeout)
+		{
+			Ping ping;
+			auto stat = ping.Sweep(vector<SocketAddress>{ addr }, count, 0, timeout)[0];
+			return make_tuple(stat.AverageRtt, stat.Lost);
+		}
+
+		// Private
+
+		bool Ping::SendProbe(const SocketAddress& target, uint32_t index, Buffer& packet)
+		{
+			auto field = packet.Field();
+			field[0] = ICMP_ECHO_REQUEST;
+			field[1] = 0;
+			*((uint16_t*)(field + 2)) = 0;
+			*((uint16_t*)(field + 4)) = htons(_Id);
+			*((uint16_t*)(field + 6)) = htons((uint16_t)index);
+			// The sequence number wraps after 65536 probes, so the full index rides in the payload.
+			*((uint32_t*)(field + 8)) = index;
+			*((uint32_t*)(field + 12)) = ~index;
+			*((uint32_t*)(field + 16)) = _Generation;
+			*((uint16_t*)(field + 2)) = Checksum(field, PACKET_LENGTH);
+			// Errors such as ENETUNREACH concern this target alone; the others are still probed.
+			try
+			{
+				_Socket.SendTo(packet, target);
+				return true;
+			}
+			catch (const runtime_error&)
+			{
+				return false;
+			}
+		}
+
+		void Ping::ReceiveReplies(vector<Probe>& probes, long timeout, long& pending)
+		{
+			pollfd fd = {};
+			fd.fd = _Socket.Handle();
+			fd.events = POLLIN;
+			if (poll(&fd, 1, timeout) <= 0)
+				return;
+
+			Byte reply[REPLY_BUFFER_LENGTH];
+			long length;
+			while ((length = _Socket.TryReceive(reply, REPLY_BUFFER_LENGTH, MSG_DONTWAIT)) >= 0)
+			{
+				auto now = chrono::steady_clock::now();
+				const Byte* icmp = reply;
+				if (_IsRaw)
+				{
+					// Raw sockets deliver the IP header as well.
+					size_t headerLength = (reply[0] & 0x0F) * 4;
+					if ((size_t)length < headerLength)
+						continue;
+					icmp += headerLength;
+					length -= headerLength;
+				}
+				if ((size_t)length < PACKET_LENGTH || (uint8_t)icmp[0] != ICMP_ECHO_REPLY)
+					continue;
+
+				// Datagram sockets have the identifier rewritten by the kernel, which then only hands over our own replies.
+				if (_IsRaw && ntohs(*((const uint16_t*)(icmp + 4))) != _Id)
+					continue;
+				uint16_t sequence = ntohs(*((const uint16_t*)(icmp + 6)));
+				uint32_t index = *((const uint32_t*)(icmp + 8));
+				if (index >= probes.size() || (uint16_t)index != sequence || *((const uint32_t*)(icmp + 12)) != ~index)
+					continue;
+				// A late reply to an earlier sweep, whose index may not even be sent yet in this one.
+				if (*((const uint32_t*)(icmp + 16)) != _Generation)
+					continue;
+
+				auto& probe = probes[index];
+				if (probe.IsAnswered)
+					continue;
+				probe.IsAnswered = true;
+				probe.Rtt = chrono::duration<double, milli>(now - probe.SentAt).count();
+				--pending;
+			}
+		}
+	}
+}
+#endif // !_L_WINDOWS
@@ -1,37 +1,66 @@
 // File: Ping.hpp
 // Author: Rendong Liang (Liong)
+#pragma once
 #include "../Fundamental.hpp"
 #include "Socket.hpp"
 
+#ifndef _L_WINDOWS
 namespace LiongPlus
 {
 	namespace Net
 	{
 		using namespace std;
+
+		/*
+		 * An ICMP echo engine. All probes go through one socket and are sent without waiting for replies, so thousands of probes can be in flight at once. Replies are matched back to probes by identifier, sequence number and the sweep they belong to.
+		 * Only IPv4 targets are supported; IPv6 would need ICMPv6 and a socket of its own.
+		 * [note] An unprivileged ICMP datagram socket is used when the system allows it (net.ipv4.ping_group_range); otherwise a raw socket, which needs CAP_NET_RAW. The constructor throws std::system_error with EACCES or EPERM if neither is allowed.
+		 */
 		class Ping
 		{
-			static atomic_bool shouldExit;
 		public:
-			static tuple<double, long> MakePing(SocketAddress& addr, long count, long timeout)
+			struct Statistics
 			{
-				std::future<bool> rslt = std::async(std::launch::sync, addr, timeout);
-				rslt.wait_for(std::chrono::duration<long, std::chrono::milliseconds>(timeout));
-				
-			}
-
-			static bool MakePingImpl(SocketAddress& addr)
+				/* Round-trip times in milliseconds, 0 if no reply was received. */
+				double MinRtt, AverageRtt, P99Rtt;
+				long Sent, Received, Lost;
+			};
+		private:
+			struct Probe
 			{
-				Socket socket(AF_INET, SOCK_RAW, IPPROTO_ICMP);
-				Buffer buffer(8);
-				buffer.Wipe();
-				auto addr = IPv4EndPoint("127.0.0.1", 0);
+				size_t Target;
+				chrono::steady_clock::time_point SentAt;
+				double Rtt;
+				bool IsAnswered;
+			};
+
+			Socket _Socket;
+			bool _IsRaw;
+			uint16_t _Id;
+			// Changed on every sweep, so that late replies to an earlier one are told apart.
+			uint32_t _Generation;
+
+			/* [return] False if the probe could not be sent, e.g. the target is unreachable. */
+			bool SendProbe(const SocketAddress& target, uint32_t index, Buffer& packet);
+			/* Receive every reply available within $timeout milliseconds. */
+			void ReceiveReplies(vector<Probe>& probes, long timeout, long& pending);
+		public:
+			Ping();
+			Ping(const Ping&) = delete;
+			Ping(Ping&&) = delete;
+
+			/*
+			 * Send $count echo requests to each of $targets, a round every $interval milliseconds, and wait at most $timeout milliseconds after the last round for replies.
+			 * $targets must be IPv4 addresses. A probe that cannot be sent counts as lost.
+			 * [return] Statistics of each target, in the same order as $targets.
+			 */
+			vector<Statistics> Sweep(const vector<SocketAddress>& targets, long count, long interval, long timeout);
 
-				socket.SendTo(buffer, addr);
-				socket.ReceiveFrom(buffer, addr);
-				if (buffer[0] == 8)
-					return true;
-				else return false;
-			}
+			/*
+			 * [return] The average round-trip time in milliseconds and the number of lost probes.
+			 */
+			static tuple<double, long> MakePing(SocketAddress& addr, long count, long timeout);
 		};
 	}
 }
+#endif // !_L_WINDOWS
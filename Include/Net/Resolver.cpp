@@ -0,0 +1,244 @@
+// File: Resolver.cpp
+// Author: Rendong Liang (Liong)
+#include "Resolver.hpp"
+
+namespace LiongPlus
+{
+	namespace Net
+	{
+		using namespace std::chrono;
+
+		// Bound to a reference by std::max(), so it needs a definition.
+		const size_t Resolver::MIN_PRUNE_COUNT;
+
+		Resolver::Resolver()
+			: Resolver(2, seconds(60), seconds(5), SystemLookup)
+		{
+		}
+		Resolver::Resolver(size_t workerCount, steady_clock::duration ttl, steady_clock::duration negativeTtl)
+			: Resolver(workerCount, ttl, negativeTtl, SystemLookup)
+		{
+		}
+		Resolver::Resolver(size_t workerCount, steady_clock::duration ttl, steady_clock::duration negativeTtl, TLookup lookup)
+			: _Lookup(lookup)
+			, _Ttl(ttl)
+			, _NegativeTtl(negativeTtl)
+			, _QueueMutex()
+			, _QueueCond()
+			, _Queue()
+			, _ShouldExit(false)
+			, _Workers()
+		{
+			for (auto& shard : _Shards)
+				shard.PruneAt = MIN_PRUNE_COUNT;
+			// Both families of a name are looked up at the same time, so there should be at least two workers.
+			workerCount = std::max(workerCount, (size_t)2);
+			for (size_t i = 0; i < workerCount; ++i)
+				_Workers.emplace_back([this] { Work(); });
+		}
+		Resolver::~Resolver()
+		{
+			{
+				std::lock_guard<std::mutex> lock(_QueueMutex);
+				_ShouldExit = true;
+			}
+			_QueueCond.notify_all();
+			for (auto& worker : _Workers)
+				worker.join();
+		}
+
+		void Resolver::ResolveAsync(const std::string& name, TCallback callback)
+		{
+			auto& shard = GetShard(name);
+			std::unique_lock<std::mutex> lock(shard.Mutex);
+
+			auto entry = shard.Entries.find(name);
+			if (entry != shard.Entries.end())
+			{
+				if (entry->second.Expiry > steady_clock::now())
+				{
+					auto addrs = entry->second.Addrs;
+					auto error = entry->second.Error;
+					lock.unlock();
+					callback(addrs, error);
+					return;
+				}
+				shard.Entries.erase(entry);
+			}
+
+			auto pending = shard.Pendings.find(name);
+			if (pending != shard.Pendings.end())
+			{
+				// Someone is already looking this name up. Wait for that result instead of asking again.
+				pending->second.Callbacks.push_back(callback);
+				return;
+			}
+
+			auto& created = shard.Pendings[name];
+			created.Callbacks.push_back(callback);
+			created.Remaining = 2;
+			lock.unlock();
+
+			Enqueue([this, name] { LookUp(name, AF_INET); });
+			Enqueue([this, name] { LookUp(name, AF_INET6); });
+		}
+
+		std::vector<SocketAddress> Resolver::Resolve(const std::string& name)
+		{
+			std::vector<SocketAddress> rv;
+			if (TryGetCached(name, rv))
+				return rv;
+
+			std::promise<std::vector<SocketAddress>> promise;
+			ResolveAsync(name, [&promise](const std::vector<SocketAddress>& addrs, std::exception_ptr error)
+			{
+				if (error)
+					promise.set_exception(error);
+				else
+					promise.set_value(addrs);
+			});
+			return promise.get_future().get();
+		}
+
+		bool Resolver::TryGetCached(const std::string& name, std::vector<SocketAddress>& addrs)
+		{
+			auto& shard = GetShard(name);
+			std::lock_guard<std::mutex> lock(shard.Mutex);
+
+			auto entry = shard.Entries.find(name);
+			if (entry == shard.Entries.end() || entry->second.Error || entry->second.Expiry <= steady_clock::now())
+				return false;
+			addrs = entry->second.Addrs;
+			return true;
+		}
+
+		void Resolver::Clear()
+		{
+			for (auto& shard : _Shards)
+			{
+				std::lock_guard<std::mutex> lock(shard.Mutex);
+				shard.Entries.clear();
+				shard.PruneAt = MIN_PRUNE_COUNT;
+			}
+		}
+
+		std::vector<SocketAddress> Resolver::SystemLookup(const std::string& name, int family)
+		{
+			addrinfo hints = {};
+			hints.ai_family = family;
+			hints.ai_socktype = SOCK_STREAM;
+
+			addrinfo* list = nullptr;
+			int code = getaddrinfo(name.c_str(), nullptr, &hints, &list);
+			if (code != 0)
+				throw std::runtime_error("Failed in resolving host name.");
+
+			std::vector<SocketAddress> addrs;
+			for (auto info = list; info != nullptr; info = info->ai_next)
+			{
+				SocketAddress addr(info->ai_addrlen);
+				memcpy(addr.Field(), info->ai_addr, info->ai_addrlen);
+				addrs.push_back(addr);
+			}
+			freeaddrinfo(list);
+			return addrs;
+		}
+
+		Resolver& Resolver::Default()
+		{
+			static Resolver resolver;
+			return resolver;
+		}
+
+		// Private
+
+		Resolver::Shard& Resolver::GetShard(const std::string& name)
+		{
+			return _Shards[std::hash<std::string>()(name) % SHARD_COUNT];
+		}
+
+		void Resolver::Prune(Shard& shard)
+		{
+			auto now = steady_clock::now();
+			for (auto it = shard.Entries.begin(); it != shard.Entries.end();)
+			{
+				if (it->second.Expiry <= now)
+					it = shard.Entries.erase(it);
+				else
+					++it;
+			}
+			// Names looked up once are otherwise never asked for again and would stay forever. Doubling the threshold keeps pruning amortized constant per lookup.
+			shard.PruneAt = std::max(shard.Entries.size() * 2, MIN_PRUNE_COUNT);
+		}
+
+		void Resolver::Enqueue(Action<> job)
+		{
+			{
+				std::lock_guard<std::mutex> lock(_QueueMutex);
+				_Queue.push_back(std::move(job));
+			}
+			_QueueCond.notify_one();
+		}
+
+		void Resolver::LookUp(const std::string& name, int family)
+		{
+			std::vector<SocketAddress> addrs;
+			std::exception_ptr error;
+			try
+			{
+				addrs = _Lookup(name, family);
+			}
+			catch (...)
+			{
+				error = std::current_exception();
+			}
+
+			auto& shard = GetShard(name);
+			std::unique_lock<std::mutex> lock(shard.Mutex);
+
+			auto& pending = shard.Pendings[name];
+			(family == AF_INET ? pending.IPv4Addrs : pending.IPv6Addrs) = std::move(addrs);
+			if (error)
+				pending.Error = error;
+			if (--pending.Remaining > 0)
+				return;
+
+			// Hosts commonly have only one of the families, so the lookup failed only if both did.
+			Entry entry;
+			entry.Addrs = std::move(pending.IPv4Addrs);
+			entry.Addrs.insert(entry.Addrs.end(), pending.IPv6Addrs.begin(), pending.IPv6Addrs.end());
+			if (entry.Addrs.empty())
+				entry.Error = pending.Error ? pending.Error : std::make_exception_ptr(std::runtime_error("Failed in resolving host name."));
+			entry.Expiry = steady_clock::now() + (entry.Error ? _NegativeTtl : _Ttl);
+
+			auto callbacks = std::move(pending.Callbacks);
+			shard.Pendings.erase(name);
+			if (shard.Entries.size() >= shard.PruneAt)
+				Prune(shard);
+			auto& cached = shard.Entries[name] = std::move(entry);
+			auto result = cached.Addrs;
+			auto resultError = cached.Error;
+			lock.unlock();
+
+			for (auto& callback : callbacks)
+				callback(result, resultError);
+		}
+
+		void Resolver::Work()
+		{
+			while (true)
+			{
+				Action<> job;
+				{
+					std::unique_lock<std::mutex> lock(_QueueMutex);
+					_QueueCond.wait(lock, [this] { return _ShouldExit || !_Queue.empty(); });
+					if (_Queue.empty())
+						return;
+					job = std::move(_Queue.front());
+					_Queue.pop_front();
+				}
+				job();
+			}
+		}
+	}
+}
@@ -0,0 +1,106 @@
+// File: Resolver.hpp
+// Author: Rendong Liang (Liong)
+
+#pragma once
+#include "../Fundamental.hpp"
+#include "SocketAddress.hpp"
+
+namespace LiongPlus
+{
+	namespace Net
+	{
+		/*
+		 * An asynchronous host name resolver with a result cache.
+		 * IPv4 and IPv6 addresses are looked up in parallel on a small worker pool. Concurrent requests for the same name share one lookup, and results are cached for a time-to-live, so repeated connections to the same host cost no lookup at all.
+		 * [note] The time-to-live is the fixed one given on construction, not the one of the DNS records: getaddrinfo does not report record TTLs. Pick it no longer than the records of the hosts resolved are expected to live, or call Clear() when they are known to have changed.
+		 */
+		class Resolver
+		{
+		public:
+			/*
+			 * Look up addresses of $name in address family $family (AF_INET or AF_INET6). Throw if the name cannot be resolved.
+			 */
+			using TLookup = Func<std::vector<SocketAddress>, const std::string&, int>;
+			/*
+			 * Receive the resolved addresses, or the error if the name cannot be resolved at all. May be called on a worker thread or, on a cache hit, on the calling thread.
+			 */
+			using TCallback = Action<const std::vector<SocketAddress>&, std::exception_ptr>;
+		private:
+			static const size_t SHARD_COUNT = 16;
+			// Expired entries of a shard are pruned once it holds this many, at the least.
+			static const size_t MIN_PRUNE_COUNT = 64;
+
+			struct Entry
+			{
+				std::vector<SocketAddress> Addrs;
+				std::exception_ptr Error;
+				std::chrono::steady_clock::time_point Expiry;
+			};
+			struct Pending
+			{
+				std::vector<TCallback> Callbacks;
+				std::vector<SocketAddress> IPv4Addrs, IPv6Addrs;
+				std::exception_ptr Error;
+				int Remaining;
+			};
+			struct Shard
+			{
+				std::mutex Mutex;
+				std::unordered_map<std::string, Entry> Entries;
+				std::unordered_map<std::string, Pending> Pendings;
+				// Entry count at which expired entries are pruned next.
+				size_t PruneAt;
+			};
+
+			TLookup _Lookup;
+			std::chrono::steady_clock::duration _Ttl, _NegativeTtl;
+			Shard _Shards[SHARD_COUNT];
+
+			std::mutex _QueueMutex;
+			std::condition_variable _QueueCond;
+			std::deque<Action<>> _Queue;
+			bool _ShouldExit;
+			std::vector<std::thread> _Workers;
+
+			Shard& GetShard(const std::string& name);
+			void Prune(Shard& shard);
+			void Enqueue(Action<> job);
+			void LookUp(const std::string& name, int family);
+			void Work();
+		public:
+			/*
+			 * Two workers, caching addresses for 60 seconds and failures for 5.
+			 */
+			Resolver();
+			/*
+			 * [param] ttl How long resolved addresses are cached.
+			 * [param] negativeTtl How long a failure to resolve is cached.
+			 */
+			Resolver(size_t workerCount, std::chrono::steady_clock::duration ttl, std::chrono::steady_clock::duration negativeTtl);
+			Resolver(size_t workerCount, std::chrono::steady_clock::duration ttl, std::chrono::steady_clock::duration negativeTtl, TLookup lookup);
+			Resolver(const Resolver&) = delete;
+			Resolver(Resolver&&) = delete;
+			~Resolver();
+
+			/*
+			 * Resolve $name and pass the addresses to $callback. IPv4 addresses come first.
+			 */
+			void ResolveAsync(const std::string& name, TCallback callback);
+			/*
+			 * Resolve $name, blocking the calling thread on a cache miss.
+			 */
+			std::vector<SocketAddress> Resolve(const std::string& name);
+			/*
+			 * [return] True if fresh addresses of $name are cached, which are then copied to $addrs.
+			 */
+			bool TryGetCached(const std::string& name, std::vector<SocketAddress>& addrs);
+			void Clear();
+
+			/*
+			 * The default lookup, based on getaddrinfo. It consults the hosts file as well as DNS.
+			 */
+			static std::vector<SocketAddress> SystemLookup(const std::string& name, int family);
+			static Resolver& Default();
+		};
+	}
+}
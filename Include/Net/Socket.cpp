@@ -1,6 +1,14 @@
 // File: Socket.cpp
 // Author: Rendong Liang (Liong)
 #include "Socket.hpp"
+#include "../Diagnostics/Metrics.hpp"
+#include "../Diagnostics/Trace.hpp"
+
+#if defined(_L_LINUX)
+#include <sys/sendfile.h>
+#elif defined(_L_WINDOWS)
+#include <io.h>
+#endif
 
 namespace LiongPlus
 {
@@ -8,6 +16,18 @@ namespace LiongPlus
 	{
 		using std::swap;
 
+		// Looked up once; the registry keeps its metrics for the whole process.
+		static Diagnostics::Counter& SentBytes()
+		{
+			static auto& counter = Diagnostics::MetricsRegistry::Default().GetCounter("liong_socket_sent_bytes_total", "Bytes sent through sockets.");
+			return counter;
+		}
+		static Diagnostics::Counter& ReceivedBytes()
+		{
+			static auto& counter = Diagnostics::MetricsRegistry::Default().GetCounter("liong_socket_received_bytes_total", "Bytes received through sockets.");
+			return counter;
+		}
+
 		StartUpNetModule::StartUpNetModule()
 		{
 #ifdef _L_WINDOWS
@@ -39,10 +59,11 @@ namespace LiongPlus
 			_HSocket = socket(addressFamily, type, protocal);
 #ifdef _L_WINDOWS
 			if (_HSocket == INVALID_SOCKET)
+				throw std::system_error(WSAGetLastError(), std::system_category(), "Failed in creating socket.");
 #else
 			if (_HSocket < 0)
+				throw std::system_error(errno, std::system_category(), "Failed in creating socket.");
 #endif
-				throw std::runtime_error("Failed in creating socket.");
 		}
 		Socket::Socket(Socket&& instance)
 			: Socket()
@@ -67,7 +88,7 @@ namespace LiongPlus
 
 		Socket Socket::Accept(SocketAddress& addr)
 		{
-			int len = addr.Length();
+			socklen_t len = SocketAddress::MAX_LENGTH;
 			HSocket code = accept(_HSocket, (sockaddr*)addr.Field(), &len);
 #ifdef _L_WINDOWS
 			if (code == INVALID_SOCKET)
@@ -75,7 +96,8 @@ namespace LiongPlus
 			if (code < 0)
 #endif
 				throw std::runtime_error("Failed in accepting incoming connection.");
-			else return Socket(code);
+			addr._Length = len;
+			return Socket(code);
 		}
 
 		void Socket::Bind(const SocketAddress& addr)
@@ -114,13 +136,19 @@ namespace LiongPlus
 
 		void Socket::Send(const Buffer& buffer)
 		{
-			if (send(_HSocket, buffer.Field(), buffer.Length(), 0) < 0)
+			_L_Trace_Span("net", "Socket::Send");
+			auto rv = send(_HSocket, buffer.Field(), buffer.Length(), 0);
+			if (rv < 0)
 				throw std::runtime_error("Failed in sending data.");
+			SentBytes().Add(rv);
 		}
 		void Socket::Send(const Buffer& buffer, int flags)
 		{
-			if (send(_HSocket, buffer.Field(), buffer.Length(), flags) < 0)
+			_L_Trace_Span("net", "Socket::Send");
+			auto rv = send(_HSocket, buffer.Field(), buffer.Length(), flags);
+			if (rv < 0)
 				throw std::runtime_error("Failed in sending data.");
+			SentBytes().Add(rv);
 		}
 
 		void Socket::SetOption(int flags, uint32_t value)
@@ -135,42 +163,322 @@ namespace LiongPlus
 
 		void Socket::Receive(Buffer& buffer)
 		{
-
-			if (recv(_HSocket, buffer.Field(), buffer.Length(), 0) < 0)
+			_L_Trace_Span("net", "Socket::Receive");
+			auto rv = recv(_HSocket, buffer.Field(), buffer.Length(), 0);
+			if (rv < 0)
 				throw std::runtime_error("Failed in receiving data.");
+			ReceivedBytes().Add(rv);
 		}
 		void Socket::Receive(Buffer& buffer, int flags)
 		{
-			if (recv(_HSocket, buffer.Field(), buffer.Length(), flags) < 0)
+			_L_Trace_Span("net", "Socket::Receive");
+			auto rv = recv(_HSocket, buffer.Field(), buffer.Length(), flags);
+			if (rv < 0)
 				throw std::runtime_error("Failed in receiving data.");
+			ReceivedBytes().Add(rv);
 		}
 
 		void Socket::SendTo(Buffer& buffer, const SocketAddress& addr)
 		{
-			if (sendto(_HSocket, buffer.Field(), buffer.Length(), 0, (const sockaddr*)addr.Field(), addr.Length()) < 0)
+			_L_Trace_Span("net", "Socket::SendTo");
+			auto rv = sendto(_HSocket, buffer.Field(), buffer.Length(), 0, (const sockaddr*)addr.Field(), addr.Length());
+			if (rv < 0)
 				throw std::runtime_error("Failed in sending data to a certain address");
+			SentBytes().Add(rv);
 		}
 		void Socket::SendTo(Buffer& buffer, const SocketAddress& addr, int flags)
 		{
-			if (sendto(_HSocket, buffer.Field(), buffer.Length(), flags, (const sockaddr*)addr.Field(), addr.Length()) < 0)
+			_L_Trace_Span("net", "Socket::SendTo");
+			auto rv = sendto(_HSocket, buffer.Field(), buffer.Length(), flags, (const sockaddr*)addr.Field(), addr.Length());
+			if (rv < 0)
 				throw std::runtime_error("Failed in sending data to a certain address");
+			SentBytes().Add(rv);
 		}
 
 		void Socket::ReceiveFrom(Buffer& buffer, SocketAddress& addr)
 		{
-			int len = addr.Length();
-			if (recvfrom(_HSocket, buffer.Field(), buffer.Length(), 0, (sockaddr*)addr.Field(), &len) < 0)
+			_L_Trace_Span("net", "Socket::ReceiveFrom");
+			socklen_t len = SocketAddress::MAX_LENGTH;
+			auto rv = recvfrom(_HSocket, buffer.Field(), buffer.Length(), 0, (sockaddr*)addr.Field(), &len);
+			if (rv < 0)
 				throw std::runtime_error("Failed in receiving data from a certain address.");
+			addr._Length = len;
+			ReceivedBytes().Add(rv);
 		}
 		void Socket::ReceiveFrom(Buffer& buffer, SocketAddress& addr, int flags)
 		{
-			int len = addr.Length();
-			if (recvfrom(_HSocket, buffer.Field(), buffer.Length(), flags, (sockaddr*)addr.Field(), &len) < 0)
+			_L_Trace_Span("net", "Socket::ReceiveFrom");
+			socklen_t len = SocketAddress::MAX_LENGTH;
+			auto rv = recvfrom(_HSocket, buffer.Field(), buffer.Length(), flags, (sockaddr*)addr.Field(), &len);
+			if (rv < 0)
+				throw std::runtime_error("Failed in receiving data from a certain address.");
+			addr._Length = len;
+			ReceivedBytes().Add(rv);
+		}
+
+		size_t Socket::SendBatch(DatagramBatch& batch, size_t count, int flags)
+		{
+			_L_Trace_Span("net", "Socket::SendBatch");
+			if (count > batch.Capacity())
+				throw std::runtime_error("$count exceeds the capacity of $batch.");
+			// Lengths are set through a plain reference, so nothing else stops one from running past its buffer.
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (batch._Lengths[i] > batch._Buffers[i].Length())
+					throw std::runtime_error("$batch has a length exceeding its buffer.");
+			}
+#ifdef _L_LINUX
+			for (size_t i = 0; i < count; ++i)
+			{
+				// Data() hands out the buffer itself, which may have been replaced since.
+				batch._Vectors[i].iov_base = batch._Buffers[i].Field();
+				batch._Vectors[i].iov_len = batch._Lengths[i];
+				batch._Headers[i].msg_hdr.msg_namelen = batch._AddrLengths[i];
+			}
+			int rv = sendmmsg(_HSocket, batch._Headers.data(), count, flags);
+			if (rv < 0)
+			{
+				if (IsWouldBlock())
+					return 0;
+				throw std::runtime_error("Failed in sending data to a certain address");
+			}
+			for (int i = 0; i < rv; ++i)
+				SentBytes().Add(batch._Headers[i].msg_len);
+			return rv;
+#else
+			for (size_t i = 0; i < count; ++i)
+			{
+				auto rv = sendto(_HSocket, batch._Buffers[i].Field(), batch._Lengths[i], flags, batch.Address(i), batch._AddrLengths[i]);
+				if (rv < 0)
+				{
+					if (IsWouldBlock())
+						return i;
+					throw std::runtime_error("Failed in sending data to a certain address");
+				}
+				SentBytes().Add(rv);
+			}
+			return count;
+#endif
+		}
+
+		void Socket::SendFile(int fd, size_t offset, size_t count)
+		{
+			_L_Trace_Span("net", "Socket::SendFile");
+			while (count > 0)
+			{
+				auto sent = TrySendFile(fd, offset, count);
+				if (sent < 0)
+					throw std::runtime_error("Failed in sending file: the socket is non-blocking.");
+				if (sent == 0)
+					throw std::runtime_error("Failed in sending file: $fd ends before $count bytes.");
+				offset += sent;
+				count -= sent;
+			}
+		}
+
+		size_t Socket::ReceiveBatch(DatagramBatch& batch, int flags)
+		{
+			_L_Trace_Span("net", "Socket::ReceiveBatch");
+			size_t count = batch.Capacity();
+			if (count == 0)
+				return 0;
+#ifdef _L_LINUX
+			// The kernel overwrites the name lengths, so they are reset on each call.
+			for (size_t i = 0; i < count; ++i)
+			{
+				batch._Vectors[i].iov_base = batch._Buffers[i].Field();
+				batch._Vectors[i].iov_len = batch._Buffers[i].Length();
+				batch._Headers[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+			}
+			// Without MSG_WAITFORONE a blocking socket would wait until every slot is filled.
+			int rv = recvmmsg(_HSocket, batch._Headers.data(), count, flags | MSG_WAITFORONE, nullptr);
+			if (rv < 0)
+			{
+				if (IsWouldBlock())
+					return 0;
+				throw std::runtime_error("Failed in receiving data from a certain address.");
+			}
+			for (int i = 0; i < rv; ++i)
+			{
+				batch._Lengths[i] = batch._Headers[i].msg_len;
+				batch._AddrLengths[i] = batch._Headers[i].msg_hdr.msg_namelen;
+				ReceivedBytes().Add(batch._Lengths[i]);
+			}
+			return rv;
+#else
+			// Without a batched call only the first receive may block, so a single datagram is taken.
+			socklen_t len = sizeof(sockaddr_storage);
+			auto rv = recvfrom(_HSocket, batch._Buffers[0].Field(), batch._Buffers[0].Length(), flags, (sockaddr*)&batch._Addrs[0], &len);
+			if (rv < 0)
+			{
+				if (IsWouldBlock())
+					return 0;
 				throw std::runtime_error("Failed in receiving data from a certain address.");
+			}
+			batch._Lengths[0] = rv;
+			batch._AddrLengths[0] = len;
+			ReceivedBytes().Add(rv);
+			return 1;
+#endif
+		}
+
+		Socket::HSocket Socket::Handle() const
+		{
+			return _HSocket;
+		}
+
+		bool Socket::IsValid() const
+		{
+#ifdef _L_WINDOWS
+			return _HSocket != INVALID_SOCKET;
+#else
+			return _HSocket >= 0;
+#endif
+		}
+
+		void Socket::SetBlocking(bool isBlocking)
+		{
+#ifdef _L_WINDOWS
+			u_long mode = isBlocking ? 0 : 1;
+			if (IsErrorOccured(ioctlsocket(_HSocket, FIONBIO, &mode)))
+#else
+			int flags = fcntl(_HSocket, F_GETFL, 0);
+			flags = isBlocking ? flags & ~O_NONBLOCK : flags | O_NONBLOCK;
+			if (IsErrorOccured(fcntl(_HSocket, F_SETFL, flags)))
+#endif
+				throw std::runtime_error("Failed in switching blocking mode.");
+		}
+
+		long Socket::TrySend(const Byte* data, size_t length, int flags)
+		{
+			_L_Trace_Span("net", "Socket::TrySend");
+#ifndef _L_WINDOWS
+			flags |= MSG_NOSIGNAL;
+#endif
+			auto rv = send(_HSocket, data, length, flags);
+			if (rv < 0)
+			{
+				if (IsWouldBlock())
+					return -1;
+				throw std::runtime_error("Failed in sending data.");
+			}
+			SentBytes().Add(rv);
+			return rv;
+		}
+
+		long Socket::TrySendFile(int fd, size_t offset, size_t count)
+		{
+			_L_Trace_Span("net", "Socket::TrySendFile");
+#ifdef _L_LINUX
+			// Unlike send(), sendfile(2) cannot suppress SIGPIPE; servers should ignore the signal.
+			off_t position = offset;
+			auto rv = sendfile(_HSocket, fd, &position, count);
+			if (rv < 0)
+			{
+				if (IsWouldBlock())
+					return -1;
+				throw std::runtime_error("Failed in sending file.");
+			}
+			SentBytes().Add(rv);
+			return rv;
+#else
+			// One chunk per call, so a send that would block wastes at most one read.
+			Byte chunk[16384];
+			size_t length = count < sizeof(chunk) ? count : sizeof(chunk);
+#ifdef _L_WINDOWS
+			long read = _lseeki64(fd, offset, SEEK_SET) < 0 ? -1 : _read(fd, chunk, (unsigned)length);
+#else
+			long read = pread(fd, chunk, length, offset);
+#endif
+			if (read < 0)
+				throw std::runtime_error("Failed in reading file.");
+			if (read == 0)
+				return 0;
+			// Counted by TrySend().
+			return TrySend(chunk, read, 0);
+#endif
+		}
+
+		long Socket::TryReceive(Byte* data, size_t length, int flags)
+		{
+			_L_Trace_Span("net", "Socket::TryReceive");
+			auto rv = recv(_HSocket, data, length, flags);
+			if (rv < 0)
+			{
+				if (IsWouldBlock())
+					return -1;
+				throw std::runtime_error("Failed in receiving data.");
+			}
+			ReceivedBytes().Add(rv);
+			return rv;
+		}
+
+		Socket Socket::TryAccept(SocketAddress& addr)
+		{
+			socklen_t len = SocketAddress::MAX_LENGTH;
+#ifdef _L_LINUX
+			// accept4 hands out the socket already non-blocking, saving two fcntl calls per connection.
+			HSocket code = accept4(_HSocket, (sockaddr*)addr.Field(), &len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+			HSocket code = accept(_HSocket, (sockaddr*)addr.Field(), &len);
+#endif
+#ifdef _L_WINDOWS
+			if (code == INVALID_SOCKET)
+#else
+			if (code < 0)
+#endif
+			{
+				// Taken before anything else can overwrite it, so callers can tell running out of descriptors from a dropped peer.
+#ifdef _L_WINDOWS
+				int error = WSAGetLastError();
+#else
+				int error = errno;
+#endif
+				if (IsWouldBlock())
+					return Socket();
+				throw std::system_error(error, std::system_category(), "Failed in accepting incoming connection.");
+			}
+			addr._Length = len;
+			Socket socket(code);
+#ifndef _L_LINUX
+			socket.SetBlocking(false);
+#endif
+			return socket;
+		}
+
+		bool Socket::TryConnect(const SocketAddress& addr)
+		{
+			if (!IsErrorOccured(connect(_HSocket, (const sockaddr*)addr.Field(), addr.Length())))
+				return true;
+#ifdef _L_WINDOWS
+			if (WSAGetLastError() == WSAEWOULDBLOCK)
+#else
+			if (errno == EINPROGRESS)
+#endif
+				return false;
+			throw std::runtime_error("Failed in connectiong to a certain address.");
+		}
+
+		int Socket::PendingError()
+		{
+			int code = 0;
+			socklen_t len = sizeof(code);
+			if (IsErrorOccured(getsockopt(_HSocket, SOL_SOCKET, SO_ERROR, (char*)&code, &len)))
+				throw std::runtime_error("Failed in fetching socket error.");
+			return code;
 		}
 
 		// Private
 
+		bool Socket::IsWouldBlock()
+		{
+#ifdef _L_WINDOWS
+			return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+			return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+		}
+
 		bool Socket::IsErrorOccured(int code)
 		{
 #ifdef _L_WINDOWS
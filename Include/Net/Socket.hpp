@@ -4,6 +4,7 @@
 #pragma once
 #include "../Fundamental.hpp"
 #include "../Buffer.hpp"
+#include "DatagramBatch.hpp"
 #include "SocketAddress.hpp"
 
 namespace LiongPlus
@@ -29,19 +30,24 @@ namespace LiongPlus
 
 		class Socket
 		{
-		private:
+		public:
 #ifdef _L_WINDOWS
 			typedef SOCKET HSocket;
 #else
 			typedef int HSocket;
 #endif
+		private:
 			HSocket _HSocket;
 
 			Socket(HSocket hSocket);
 
 			bool IsErrorOccured(int code);
+			bool IsWouldBlock();
 		public:
 			Socket();
+			/*
+			 * Throws std::system_error carrying the error code, e.g. EACCES for a socket type the process may not open.
+			 */
 			Socket(int addressFamily, int type, int protocal);
 			Socket(const Socket&) = delete;
 			Socket(Socket&& instance);
@@ -64,6 +70,40 @@ namespace LiongPlus
 			void SendTo(Buffer& buffer, const SocketAddress& addr, int flags);
 			void ReceiveFrom(Buffer& buffer, SocketAddress& addr);
 			void ReceiveFrom(Buffer& buffer, SocketAddress& addr, int flags);
+
+			/*
+			 * Send the first $count datagrams of $batch, each to its own address. On Linux this is one sendmmsg call.
+			 * [return] The number of datagrams sent, 0 if a non-blocking socket would block.
+			 */
+			size_t SendBatch(DatagramBatch& batch, size_t count, int flags);
+			/*
+			 * Receive up to $batch.Capacity() datagrams with their lengths and source addresses. On Linux this is one recvmmsg call.
+			 * [return] The number of datagrams received, 0 if a non-blocking socket would block.
+			 */
+			size_t ReceiveBatch(DatagramBatch& batch, int flags);
+			/*
+			 * Send $count bytes of the open file $fd from $offset. On Linux this is sendfile(2), so the bytes never enter user space; elsewhere they are read and sent in chunks.
+			 * [note] Throws if the file ends before $count bytes.
+			 */
+			void SendFile(int fd, size_t offset, size_t count);
+
+			// Non-blocking mode.
+
+			HSocket Handle() const;
+			bool IsValid() const;
+			void SetBlocking(bool isBlocking);
+			/* [return] The number of bytes sent, or -1 if the operation would block. */
+			long TrySend(const Byte* data, size_t length, int flags);
+			/* [return] The number of bytes of $fd sent from $offset, up to $count, or -1 if the operation would block. 0 if the file ends at $offset. */
+			long TrySendFile(int fd, size_t offset, size_t count);
+			/* [return] The number of bytes received, or -1 if the operation would block. */
+			long TryReceive(Byte* data, size_t length, int flags);
+			/* [return] The accepted socket, which is non-blocking, or an invalid socket if no connection is pending. Throws std::system_error carrying the error code on failure. */
+			Socket TryAccept(SocketAddress& addr);
+			/* [return] True if connected; false if the connection is still in progress. */
+			bool TryConnect(const SocketAddress& addr);
+			/* Fetch and clear the pending error code (SO_ERROR), 0 if there is none. */
+			int PendingError();
 		};
 	}
 }
\ No newline at end of file
@@ -2,182 +2,170 @@
 // Author: Rendong Liang (Liong)
 
 #include "SocketAddress.hpp"
+#include <cstring>
 
 namespace LiongPlus
 {
 	namespace Net
 	{
-		SocketAddress::SocketAddress(size_t length)
-			: _Addr(length)
-		{
-			_Addr.Wipe();
-		}
-		SocketAddress::SocketAddress(const SocketAddress& instance)
-			: _Addr(instance._Addr)
-		{
-		}
-		SocketAddress::SocketAddress(SocketAddress&& instance)
-			: _Addr()
-		{
-			swap(_Addr, instance._Addr);
-		}
-		SocketAddress::~SocketAddress()
-		{
-		}
+		static_assert(std::is_trivially_copyable<SocketAddress>::value, "SocketAddress should be copied with plain memory copies.");
 
-		SocketAddress& SocketAddress::operator=(const SocketAddress& instance)
+		SocketAddress::SocketAddress()
+			: _Length(0)
 		{
-			_Addr = instance._Addr;
-			return *this;
+			// Only the family is cleared, so that an empty address never reads as a stale AF_INET one.
+			_Addr.ss_family = AF_UNSPEC;
 		}
-		SocketAddress& SocketAddress::operator=(SocketAddress&& instance)
+		SocketAddress::SocketAddress(size_t length)
+			: _Length(length)
 		{
-			swap(_Addr, instance._Addr);
-			return *this;
+			if (length > MAX_LENGTH)
+				throw std::runtime_error("$length exceeds the size of sockaddr_storage.");
+			memset(&_Addr, 0, length);
 		}
+
 		Byte& SocketAddress::operator[](size_t index)
 		{
-			return _Addr[index];
+			if (index < _Length)
+				return Field()[index];
+			else throw std::runtime_error("$index is out of range.");
 		}
 
 		size_t SocketAddress::Length() const
 		{
-			return _Addr.Length();
+			return _Length;
 		}
 
 		Byte* SocketAddress::Field()
 		{
-			return _Addr.Field();
+			return reinterpret_cast<Byte*>(&_Addr);
 		}
 		const Byte* SocketAddress::Field() const
 		{
-			return _Addr.Field();
+			return reinterpret_cast<const Byte*>(&_Addr);
 		}
 
 		uint16_t& SocketAddress::AddressFamily()
 		{
-			return *((uint16_t*)_Addr.Field());
+			return *((uint16_t*)Field());
 		}
 		uint16_t SocketAddress::AddressFamily() const
 		{
-			return *((uint16_t*)_Addr.Field());
+			return *((uint16_t*)Field());
 		}
 
 		std::string SocketAddress::ToString() const
 		{
-			return "";
+			char name[INET6_ADDRSTRLEN];
+			uint16_t port;
+			if (_Length >= sizeof(sockaddr_in) && AddressFamily() == AF_INET)
+			{
+				auto addr = reinterpret_cast<const sockaddr_in*>(&_Addr);
+				inet_ntop(AF_INET, (void*)&addr->sin_addr, name, sizeof(name));
+				port = ntohs(addr->sin_port);
+			}
+			else if (_Length >= sizeof(sockaddr_in6) && AddressFamily() == AF_INET6)
+			{
+				auto addr = reinterpret_cast<const sockaddr_in6*>(&_Addr);
+				inet_ntop(AF_INET6, (void*)&addr->sin6_addr, name, sizeof(name));
+				port = ntohs(addr->sin6_port);
+				if (port != 0)
+					return '[' + std::string(name) + "]:" + std::to_string(port);
+			}
+			else return "";
+
+			auto rv = std::string(name);
+			if (port != 0)
+				rv += ':' + std::to_string(port);
+			return rv;
 		}
 
 
 
-		IPv4EndPoint::IPv4EndPoint(const IPv4EndPoint& instance)
-			: SocketAddress(instance)
-		{
-		}
-		IPv4EndPoint::IPv4EndPoint(IPv4EndPoint&& instance)
-			: SocketAddress(std::forward<IPv4EndPoint>(instance))
-		{
-		}
 		IPv4EndPoint::IPv4EndPoint(const std::string name, uint16_t port)
 			: SocketAddress(sizeof(sockaddr_in))
 		{
-			if (inet_pton(AF_INET, name.c_str(), _Addr.Field() + 4) != 1)
+			if (inet_pton(AF_INET, name.c_str(), Field() + 4) != 1)
 				throw std::runtime_error("Failed in interpreting IPv4 address.");
-			*((uint16_t*)(_Addr.Field() + 2)) = htons(port);
-			*((uint16_t*)_Addr.Field()) = AF_INET;
+			*((uint16_t*)(Field() + 2)) = htons(port);
+			*((uint16_t*)Field()) = AF_INET;
 		}
 		IPv4EndPoint::IPv4EndPoint(const uint8_t* addr_be, uint16_t port)
 			:SocketAddress(sizeof(sockaddr_in))
 		{
-			*((uint32_t*)(_Addr.Field() + 4)) = *((uint32_t*)addr_be);
-			*((uint16_t*)(_Addr.Field() + 2)) = htons(port);
-			*((uint16_t*)_Addr.Field()) = AF_INET;
+			*((uint32_t*)(Field() + 4)) = *((uint32_t*)addr_be);
+			*((uint16_t*)(Field() + 2)) = htons(port);
+			*((uint16_t*)Field()) = AF_INET;
 		}
 		IPv4EndPoint::IPv4EndPoint(uint32_t addr_le, uint16_t port)
 			: SocketAddress(sizeof(sockaddr_in))
 		{
-			*((uint32_t*)(_Addr.Field() + 4)) = htonl(addr_le);
-			*((uint16_t*)(_Addr.Field() + 2)) = htons(port);
-			*((uint16_t*)_Addr.Field()) = AF_INET;
+			*((uint32_t*)(Field() + 4)) = htonl(addr_le);
+			*((uint16_t*)(Field() + 2)) = htons(port);
+			*((uint16_t*)Field()) = AF_INET;
 		}
 
 		uint16_t& IPv4EndPoint::Port()
 		{
-			return *((uint16_t*)(_Addr.Field() + 2));
+			return *((uint16_t*)(Field() + 2));
 		}
 		uint16_t IPv4EndPoint::Port() const
 		{
-			return *((uint16_t*)(_Addr.Field() + 2));
+			return *((uint16_t*)(Field() + 2));
 		}
 
-		std::string IPv4EndPoint::ToString() const
-		{
-			auto field = (uint8_t*)_Addr.Field();
-			auto rv = std::to_string(field[4]) + '.' + std::to_string(field[5]) + '.' + std::to_string(field[6]) + '.' + std::to_string(field[7]);
-			if (Port() != 0)
-				rv += ':' + Port();
-			return rv;
-		}
 
 
-		IPv6EndPoint::IPv6EndPoint(const IPv6EndPoint& instance)
-			: SocketAddress(instance)
-		{
-		}
-		IPv6EndPoint::IPv6EndPoint(IPv6EndPoint&& instance)
-			: SocketAddress(std::forward<IPv6EndPoint>(instance))
-		{
-		}
 		IPv6EndPoint::IPv6EndPoint(const std::string name, uint16_t port)
 			: SocketAddress(sizeof(sockaddr_in6))
 		{
-			if (inet_pton(AF_INET6, name.c_str(), _Addr.Field() + 8) != 1)
+			if (inet_pton(AF_INET6, name.c_str(), Field() + 8) != 1)
 				throw std::runtime_error("Failed in interpreting IPv4 address.");
-			*((uint16_t*)(_Addr.Field() + 2)) = htons(port);
-			*((uint16_t*)_Addr.Field()) = AF_INET6;
+			*((uint16_t*)(Field() + 2)) = htons(port);
+			*((uint16_t*)Field()) = AF_INET6;
 		}
 		IPv6EndPoint::IPv6EndPoint(const uint8_t* addr_be, uint16_t port)
 			: SocketAddress(sizeof(sockaddr_in6))
 		{
-			std::copy(addr_be, addr_be + 16, _Addr.Field());
-			*((uint16_t*)(_Addr.Field() + 2)) = htons(port);
-			*((uint16_t*)_Addr.Field()) = AF_INET6;
+			std::copy(addr_be, addr_be + 16, Field() + 8);
+			*((uint16_t*)(Field() + 2)) = htons(port);
+			*((uint16_t*)Field()) = AF_INET6;
 		}
 		IPv6EndPoint::IPv6EndPoint(const uint16_t* addr_le, uint16_t port)
 			: SocketAddress(sizeof(sockaddr_in6))
 		{
 			size_t pos = 8;
 			while (pos-- > 0)
-				((uint16_t*)_Addr.Field())[4 + pos] = htons(addr_le[pos]);
-			*((uint16_t*)(_Addr.Field() + 2)) = htons(port);
-			*((uint16_t*)_Addr.Field()) = AF_INET6;
+				((uint16_t*)Field())[4 + pos] = htons(addr_le[pos]);
+			*((uint16_t*)(Field() + 2)) = htons(port);
+			*((uint16_t*)Field()) = AF_INET6;
 		}
 
 		uint16_t& IPv6EndPoint::Port()
 		{
-			return *((uint16_t*)(_Addr.Field() + 2));
+			return *((uint16_t*)(Field() + 2));
 		}
 		uint16_t IPv6EndPoint::Port() const
 		{
-			return *((uint16_t*)(_Addr.Field() + 2));
+			return *((uint16_t*)(Field() + 2));
 		}
 
 		uint32_t& IPv6EndPoint::FlowInfo()
 		{
-			return *((uint32_t*)(_Addr.Field() + 4));
+			return *((uint32_t*)(Field() + 4));
 		}
 		uint32_t IPv6EndPoint::FlowInfo() const
 		{
-			return *((uint32_t*)(_Addr.Field() + 4));
+			return *((uint32_t*)(Field() + 4));
 		}
 
 		uint32_t& IPv6EndPoint::ScopeId()
 		{
-			return *((uint32_t*)(_Addr.Field() + 24));
+			return *((uint32_t*)(Field() + 24));
 		}
 		uint32_t IPv6EndPoint::ScopeId() const
 		{
-			return *((uint32_t*)(_Addr.Field() + 24));
+			return *((uint32_t*)(Field() + 24));
 		}
 	}
 }
@@ -3,25 +3,28 @@
 
 #pragma once
 #include "../Fundamental.hpp"
-#include "../Buffer.hpp"
 
 namespace LiongPlus
 {
 	namespace Net
 	{
+		/*
+		 * A raw socket address stored inline, so constructing, copying and receiving addresses never allocates. Copies are plain memory copies.
+		 */
 		class SocketAddress
 		{
+			friend class Socket;
 		protected:
-			Buffer _Addr;
+			sockaddr_storage _Addr;
+			size_t _Length;
 		public:
-			SocketAddress() = default;
+			static const size_t MAX_LENGTH = sizeof(sockaddr_storage);
+
+			SocketAddress();
 			SocketAddress(size_t length);
-			SocketAddress(const SocketAddress&);
-			SocketAddress(SocketAddress&&);
-			~SocketAddress();
+			SocketAddress(const SocketAddress&) = default;
 
-			SocketAddress& operator=(const SocketAddress&);
-			SocketAddress& operator=(SocketAddress&&);
+			SocketAddress& operator=(const SocketAddress&) = default;
 			Byte& operator[](size_t index);
 			
 			size_t Length() const;
@@ -30,7 +33,7 @@ namespace LiongPlus
 			uint16_t& AddressFamily();
 			uint16_t AddressFamily() const;
 			
-			virtual std::string ToString() const;
+			std::string ToString() const;
 		};
 
 		class IPv4EndPoint
@@ -38,8 +41,7 @@ namespace LiongPlus
 		{
 		public:
 			IPv4EndPoint() = delete;
-			IPv4EndPoint(const IPv4EndPoint&);
-			IPv4EndPoint(IPv4EndPoint&&);
+			IPv4EndPoint(const IPv4EndPoint&) = default;
 			IPv4EndPoint(const std::string name, uint16_t port);
 			IPv4EndPoint(const uint8_t* addr_be, uint16_t port);
 			/* Little endian! */
@@ -47,8 +49,6 @@ namespace LiongPlus
 			
 			uint16_t& Port();
 			uint16_t Port() const;
-
-			std::string ToString() const override;
 		};
 
 		class IPv6EndPoint
@@ -56,8 +56,7 @@ namespace LiongPlus
 		{
 		public:
 			IPv6EndPoint() = delete;
-			IPv6EndPoint(const IPv6EndPoint&);
-			IPv6EndPoint(IPv6EndPoint&&);
+			IPv6EndPoint(const IPv6EndPoint&) = default;
 			IPv6EndPoint(const std::string name, unsigned short port);
 			IPv6EndPoint(const uint8_t* addr_be, uint16_t port);
 			IPv6EndPoint(const uint16_t* addr_le, uint16_t port);
@@ -0,0 +1,320 @@
+// File: StaticFileCache.cpp
+// Author: Rendong Liang (Liong)
+#include "StaticFileCache.hpp"
+#include "HttpMessage.hpp"
+#include "../DateTime.hpp"
+#include "../Diagnostics/Metrics.hpp"
+
+#ifdef _L_LINUX
+namespace LiongPlus
+{
+	namespace Net
+	{
+		using namespace std::chrono;
+
+		static Diagnostics::Counter& Hits()
+		{
+			static auto& counter = Diagnostics::MetricsRegistry::Default().GetCounter("liong_static_file_cache_hits_total", "Static file responses served from the cache.");
+			return counter;
+		}
+		static Diagnostics::Counter& Misses()
+		{
+			static auto& counter = Diagnostics::MetricsRegistry::Default().GetCounter("liong_static_file_cache_misses_total", "Static file responses built on a cache miss or change.");
+			return counter;
+		}
+		static Diagnostics::Counter& Evictions()
+		{
+			static auto& counter = Diagnostics::MetricsRegistry::Default().GetCounter("liong_static_file_cache_evictions_total", "Static file responses evicted from the cache.");
+			return counter;
+		}
+
+		static const char* ContentTypeOf(const std::string& path)
+		{
+			static const std::pair<const char*, const char*> TYPES[] =
+			{
+				{ ".html", "text/html; charset=utf-8" },
+				{ ".htm", "text/html; charset=utf-8" },
+				{ ".css", "text/css; charset=utf-8" },
+				{ ".js", "text/javascript; charset=utf-8" },
+				{ ".json", "application/json" },
+				{ ".txt", "text/plain; charset=utf-8" },
+				{ ".svg", "image/svg+xml" },
+				{ ".png", "image/png" },
+				{ ".jpg", "image/jpeg" },
+				{ ".jpeg", "image/jpeg" },
+				{ ".gif", "image/gif" },
+				{ ".ico", "image/x-icon" },
+				{ ".bmp", "image/bmp" },
+				{ ".wasm", "application/wasm" },
+				{ ".woff2", "font/woff2" },
+				{ ".pdf", "application/pdf" },
+			};
+			auto dot = path.rfind('.');
+			if (dot != std::string::npos && path.find('/', dot) == std::string::npos)
+			{
+				auto ext = path.substr(dot);
+				for (auto& type : TYPES)
+				{
+					if (strcasecmp(ext.c_str(), type.first) == 0)
+						return type.second;
+				}
+			}
+			return "application/octet-stream";
+		}
+
+		// Relative paths only, without empty, "." or ".." segments, so nothing outside the root is reachable.
+		static bool IsSafePath(const std::string& path)
+		{
+			if (path.empty() || path[0] == '/' || path.find('\0') != std::string::npos)
+				return false;
+			size_t begin = 0;
+			while (begin <= path.size())
+			{
+				auto end = path.find('/', begin);
+				if (end == std::string::npos)
+					end = path.size();
+				auto segment = path.substr(begin, end - begin);
+				if (segment.empty() || segment == "." || segment == "..")
+					return false;
+				begin = end + 1;
+			}
+			return true;
+		}
+
+		static int64_t ModifiedAtOf(const struct stat& info)
+		{
+			return (int64_t)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+		}
+
+		static SharedBuffer BuildHead(long statusCode, const char* status, const std::vector<std::pair<std::string, std::string>>& fields)
+		{
+			HttpStatusLine line(1, 1, statusCode, status);
+			HttpHeader header;
+			for (auto& field : fields)
+			{
+				std::string key = field.first;
+				header[key] = field.second;
+			}
+			HttpResponse response(header, line, SharedBuffer());
+			return response.ToBuffer();
+		}
+
+
+
+		StaticFileCache::Entry::~Entry()
+		{
+			close(Fd);
+		}
+
+
+
+		StaticFileCache::StaticFileCache(std::string root, size_t capacity, size_t maxEntries, steady_clock::duration revalidateAfter)
+			: _RootFd(-1)
+			, _Capacity(capacity)
+			, _MaxEntries(maxEntries)
+			, _RevalidateAfter(revalidateAfter)
+			, _Mutex()
+			, _Lru()
+			, _Slots()
+			, _Size(0)
+		{
+			_RootFd = open(root.c_str(), O_PATH | O_DIRECTORY | O_CLOEXEC);
+			if (_RootFd < 0)
+				throw std::runtime_error("Failed in opening $root.");
+		}
+		StaticFileCache::~StaticFileCache()
+		{
+			close(_RootFd);
+		}
+
+		std::shared_ptr<const StaticFileCache::Entry> StaticFileCache::Get(const std::string& path)
+		{
+			auto now = steady_clock::now();
+			{
+				std::lock_guard<std::mutex> lock(_Mutex);
+				auto it = _Slots.find(path);
+				if (it != _Slots.end() && now - it->second.ValidatedAt < _RevalidateAfter)
+				{
+					_Lru.splice(_Lru.begin(), _Lru, it->second.LruPosition);
+					Hits().Add();
+					return it->second.EntryPtr;
+				}
+			}
+
+			if (!IsSafePath(path))
+				return nullptr;
+			// Identity of what was actually opened, so a file swapped for a link in between is never served.
+			int fd = OpenBeneath(path);
+			struct stat info;
+			if (fd < 0 || fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+			{
+				if (fd >= 0)
+					close(fd);
+				std::lock_guard<std::mutex> lock(_Mutex);
+				auto it = _Slots.find(path);
+				if (it != _Slots.end())
+					Erase(it);
+				return nullptr;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(_Mutex);
+				auto it = _Slots.find(path);
+				if (it != _Slots.end())
+				{
+					auto& slot = it->second;
+					if (slot.Device == info.st_dev && slot.Inode == info.st_ino && slot.Size == info.st_size && slot.ModifiedAt == ModifiedAtOf(info))
+					{
+						slot.ValidatedAt = now;
+						_Lru.splice(_Lru.begin(), _Lru, slot.LruPosition);
+						Hits().Add();
+						close(fd);
+						return slot.EntryPtr;
+					}
+				}
+			}
+
+			Misses().Add();
+			return Load(path, fd, info);
+		}
+
+		void StaticFileCache::Clear()
+		{
+			std::lock_guard<std::mutex> lock(_Mutex);
+			_Slots.clear();
+			_Lru.clear();
+			_Size = 0;
+		}
+
+		size_t StaticFileCache::Size() const
+		{
+			std::lock_guard<std::mutex> lock(_Mutex);
+			return _Size;
+		}
+		size_t StaticFileCache::Count() const
+		{
+			std::lock_guard<std::mutex> lock(_Mutex);
+			return _Slots.size();
+		}
+
+		bool StaticFileCache::IsNotModified(const Entry& entry, const std::string& ifNoneMatch)
+		{
+			// Weak comparison, as If-None-Match requires; the list may also hold W/-prefixed tags.
+			if (ifNoneMatch.empty())
+				return false;
+			if (ifNoneMatch.find('*') != std::string::npos)
+				return true;
+			return ifNoneMatch.find(entry.ETag) != std::string::npos;
+		}
+
+		void StaticFileCache::Send(Socket& socket, const Entry& entry, bool isNotModified)
+		{
+			auto& head = isNotModified ? entry.NotModifiedHead : entry.Head;
+			for (size_t sent = 0; sent < head.Length();)
+			{
+				// MSG_MORE holds the head back to share segments with the start of the body.
+				auto rv = socket.TrySend(head.Field() + sent, head.Length() - sent, isNotModified ? 0 : MSG_MORE);
+				if (rv < 0)
+					throw std::runtime_error("Failed in sending response: the socket is non-blocking.");
+				sent += rv;
+			}
+			if (!isNotModified && entry.Length > 0)
+				socket.SendFile(entry.Fd, 0, entry.Length);
+		}
+
+#ifdef _L_COROUTINE
+		Task<void> StaticFileCache::SendAsync(Socket& socket, std::shared_ptr<const Entry> entry, bool isNotModified)
+		{
+			auto& head = isNotModified ? entry->NotModifiedHead : entry->Head;
+			co_await Net::SendAsync(socket, head.Field(), head.Length());
+			if (!isNotModified && entry->Length > 0)
+				co_await SendFileAsync(socket, entry->Fd, 0, entry->Length);
+		}
+#endif
+
+		// Private
+
+		int StaticFileCache::OpenBeneath(const std::string& path) const
+		{
+			// One segment at a time, refusing symbolic links on the way, so every directory walked through is under the root.
+			int dir = _RootFd;
+			size_t begin = 0;
+			while (true)
+			{
+				auto end = path.find('/', begin);
+				bool isLast = end == std::string::npos;
+				auto segment = path.substr(begin, isLast ? std::string::npos : end - begin);
+				// Non-blocking, so that a FIFO under the root cannot stall the caller; fstat() then turns it away.
+				int fd = openat(dir, segment.c_str(), (isLast ? O_RDONLY | O_NONBLOCK : O_PATH | O_DIRECTORY) | O_NOFOLLOW | O_CLOEXEC);
+				if (dir != _RootFd)
+					close(dir);
+				if (fd < 0 || isLast)
+					return fd;
+				dir = fd;
+				begin = end + 1;
+			}
+		}
+
+		std::shared_ptr<const StaticFileCache::Entry> StaticFileCache::Load(const std::string& path, int fd, const struct stat& info)
+		{
+			auto entry = std::make_shared<Entry>();
+			entry->Fd = fd;
+			entry->Length = info.st_size;
+			// Another file at the path, or the same one rewritten, gets another tag even if the size and second match.
+			char etag[64];
+			snprintf(etag, sizeof(etag), "\"%llx-%llx-%llx\"", (unsigned long long)info.st_ino, (unsigned long long)ModifiedAtOf(info), (unsigned long long)info.st_size);
+			entry->ETag = etag;
+			auto lastModified = DateTime::GetRfc1123(info.st_mtime);
+			entry->Head = BuildHead(200, "OK",
+			{
+				{ HttpHeader::Entity::ContentType, ContentTypeOf(path) },
+				{ HttpHeader::Entity::ContentLength, std::to_string(info.st_size) },
+				{ HttpHeader::Entity::LastModified, lastModified },
+				{ HttpHeader::Response::ETag, entry->ETag },
+			});
+			entry->NotModifiedHead = BuildHead(304, "Not Modified",
+			{
+				{ HttpHeader::Entity::LastModified, lastModified },
+				{ HttpHeader::Response::ETag, entry->ETag },
+			});
+
+			Slot slot;
+			slot.EntryPtr = entry;
+			slot.Device = info.st_dev;
+			slot.Inode = info.st_ino;
+			slot.Size = info.st_size;
+			slot.ModifiedAt = ModifiedAtOf(info);
+			slot.ValidatedAt = steady_clock::now();
+			slot.Charge = entry->Head.Length() + entry->NotModifiedHead.Length() + entry->ETag.size() + path.size() * 2 + sizeof(Entry) + sizeof(Slot);
+
+			std::lock_guard<std::mutex> lock(_Mutex);
+			auto it = _Slots.find(path);
+			if (it != _Slots.end())
+				Erase(it);
+			_Lru.push_front(path);
+			slot.LruPosition = _Lru.begin();
+			_Size += slot.Charge;
+			_Slots.emplace(path, std::move(slot));
+			Evict();
+			return entry;
+		}
+
+		void StaticFileCache::Erase(std::unordered_map<std::string, Slot>::iterator it)
+		{
+			_Size -= it->second.Charge;
+			_Lru.erase(it->second.LruPosition);
+			_Slots.erase(it);
+		}
+
+		void StaticFileCache::Evict()
+		{
+			// The newest entry stays even if it alone exceeds the capacity.
+			while ((_Size > _Capacity || _Slots.size() > _MaxEntries) && _Slots.size() > 1)
+			{
+				Erase(_Slots.find(_Lru.back()));
+				Evictions().Add();
+			}
+		}
+	}
+}
+#endif // _L_LINUX
@@ -0,0 +1,103 @@
+// File: StaticFileCache.hpp
+// Author: Rendong Liang (Liong)
+
+#pragma once
+#include "../Fundamental.hpp"
+#include "../SharedBuffer.hpp"
+#include "Async.hpp"
+#include "Socket.hpp"
+
+#ifdef _L_LINUX
+namespace LiongPlus
+{
+	namespace Net
+	{
+		/*
+		 * Caches responses to static files under a root directory: the status line and headers are built once, with ETag and Last-Modified, and the file is kept open so that its body goes out with sendfile(2) without ever being read into user space.
+		 * Entries are evicted least recently used first once their total size or count exceeds the limits, and revalidated against the file system at most once per $RevalidateAfter. Thread-safe.
+		 * Paths are opened one segment at a time under the root directory without following symbolic links, so no link placed under the root leads outside it.
+		 */
+		class StaticFileCache
+		{
+		public:
+			struct Entry
+			{
+				// Head of the 200 response, terminated by the empty line.
+				SharedBuffer Head;
+				// Head of the 304 response to a request whose If-None-Match matches $ETag.
+				SharedBuffer NotModifiedHead;
+				std::string ETag;
+				int Fd;
+				size_t Length;
+
+				~Entry();
+			};
+		private:
+			struct Slot
+			{
+				std::shared_ptr<const Entry> EntryPtr;
+				// Identity of the file the entry was built from.
+				dev_t Device;
+				ino_t Inode;
+				off_t Size;
+				// In nanoseconds, so that a rewrite of the same size within a second is still noticed.
+				int64_t ModifiedAt;
+				std::chrono::steady_clock::time_point ValidatedAt;
+				std::list<std::string>::iterator LruPosition;
+				size_t Charge;
+			};
+
+			int _RootFd;
+			size_t _Capacity;
+			size_t _MaxEntries;
+			std::chrono::steady_clock::duration _RevalidateAfter;
+			mutable std::mutex _Mutex;
+			// Most recently used first.
+			std::list<std::string> _Lru;
+			std::unordered_map<std::string, Slot> _Slots;
+			size_t _Size;
+
+			int OpenBeneath(const std::string& path) const;
+			std::shared_ptr<const Entry> Load(const std::string& path, int fd, const struct stat& info);
+			void Erase(std::unordered_map<std::string, Slot>::iterator it);
+			void Evict();
+		public:
+			/*
+			 * [param] capacity Bytes of prebuilt heads and bookkeeping to keep. Bodies stay in the page cache and are not counted.
+			 * [param] maxEntries Number of files to keep open.
+			 */
+			StaticFileCache(std::string root, size_t capacity = 4 * 1024 * 1024, size_t maxEntries = 1024, std::chrono::steady_clock::duration revalidateAfter = std::chrono::seconds(1));
+			StaticFileCache(const StaticFileCache&) = delete;
+			StaticFileCache(StaticFileCache&&) = delete;
+			~StaticFileCache();
+
+			/*
+			 * Get the response to $path, relative to the root, loading it on a miss.
+			 * [return] The entry, which stays usable after eviction for as long as it is held, or nullptr if $path is not a regular file, leaves the root or goes through a symbolic link.
+			 */
+			std::shared_ptr<const Entry> Get(const std::string& path);
+			void Clear();
+			/*
+			 * [return] Bytes charged for the cached entries.
+			 */
+			size_t Size() const;
+			size_t Count() const;
+
+			/*
+			 * [return] True if $ifNoneMatch, the value of the If-None-Match header, matches the ETag of $entry.
+			 */
+			static bool IsNotModified(const Entry& entry, const std::string& ifNoneMatch);
+			/*
+			 * Send the response in $entry on a blocking socket: the head, then the body by sendfile(2) unless $isNotModified.
+			 */
+			static void Send(Socket& socket, const Entry& entry, bool isNotModified);
+#ifdef _L_COROUTINE
+			/*
+			 * Send the response in $entry on a non-blocking socket. $entry is held until the send completes.
+			 */
+			static Task<void> SendAsync(Socket& socket, std::shared_ptr<const Entry> entry, bool isNotModified);
+#endif
+		};
+	}
+}
+#endif // _L_LINUX
@@ -0,0 +1,172 @@
+// File: TcpServer.cpp
+// Author: Rendong Liang (Liong)
+#include "TcpServer.hpp"
+
+#ifdef _L_LINUX
+namespace LiongPlus
+{
+	namespace Net
+	{
+		TcpServer::Shard::Shard(TcpServer& server, EventLoop& loop, const SocketAddress& addr, int backlog)
+			: _Server(server)
+			, _Loop(loop)
+			, _Listener(addr.AddressFamily(), SOCK_STREAM, IPPROTO_TCP)
+			, _Peer(sizeof(sockaddr_storage))
+			, _SpareFd(open("/dev/null", O_RDONLY | O_CLOEXEC))
+			, _TimerFd(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC))
+			, _Backoff(*this)
+		{
+			if (_TimerFd < 0)
+				throw std::runtime_error("Failed in creating back-off timer.");
+			_Listener.SetOption(SO_REUSEADDR, 1);
+			_Listener.SetOption(SO_REUSEPORT, 1);
+			_Listener.SetBlocking(false);
+			_Listener.Bind(addr);
+			_Listener.Listen(backlog);
+		}
+		TcpServer::Shard::~Shard()
+		{
+			if (_SpareFd >= 0)
+				close(_SpareFd);
+			if (_TimerFd >= 0)
+				close(_TimerFd);
+		}
+
+		void TcpServer::Shard::Start()
+		{
+			_Loop.Watch(_Listener, EPOLLIN, this);
+		}
+
+		bool TcpServer::Shard::OnReady()
+		{
+			// Drain the accept queue, then re-arm.
+			while (true)
+			{
+				Socket socket;
+				try
+				{
+					socket = _Listener.TryAccept(_Peer);
+				}
+				catch (const std::system_error& e)
+				{
+					auto error = e.code().value();
+					// Out of descriptors, the connection stays queued and the listener is ready again at once. Re-arming would spin, so shed it instead, or rest if even that fails.
+					if (error == EMFILE || error == ENFILE)
+					{
+						if (Shed())
+							continue;
+						Backoff();
+						return true;
+					}
+					// The peer gave up before it was accepted; move on to the next one.
+					if (error == ECONNABORTED || error == EPROTO || error == EPERM || error == EINTR)
+						continue;
+					throw;
+				}
+				if (!socket.IsValid())
+					break;
+				try
+				{
+					_Server._Handler(_Loop, std::move(socket), _Peer);
+				}
+				catch (...)
+				{
+					Detail::ReportError("Connection handler failed", std::current_exception());
+				}
+			}
+			return false;
+		}
+
+		void TcpServer::Shard::OnError(std::exception_ptr error)
+		{
+			Detail::ReportError("Listener failed", error);
+			Backoff();
+		}
+
+		// Private
+
+		bool TcpServer::Shard::Shed()
+		{
+			// Lost if another thread took the descriptor while it was given up last time.
+			if (_SpareFd < 0)
+				_SpareFd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+			if (_SpareFd < 0)
+				return false;
+			// Give up the spare descriptor for the connection, and close that at once so the peer sees a reset instead of hanging in the queue.
+			close(_SpareFd);
+			bool isShed;
+			try
+			{
+				isShed = _Listener.TryAccept(_Peer).IsValid();
+			}
+			catch (...)
+			{
+				isShed = false;
+			}
+			_SpareFd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+			return isShed;
+		}
+
+		void TcpServer::Shard::Backoff()
+		{
+			itimerspec spec = {};
+			spec.it_value.tv_sec = BACKOFF_MS / 1000;
+			spec.it_value.tv_nsec = BACKOFF_MS % 1000 * 1000000;
+			// Called from OnError(), where nothing is left to catch a failure.
+			try
+			{
+				if (timerfd_settime(_TimerFd, 0, &spec, nullptr) < 0)
+					throw std::runtime_error("Failed in arming back-off timer.");
+				_Loop.Watch(_TimerFd, EPOLLIN, &_Backoff);
+			}
+			catch (...)
+			{
+				Detail::ReportError("Listener stopped accepting", std::current_exception());
+			}
+		}
+
+
+
+		TcpServer::Shard::BackoffTimer::BackoffTimer(Shard& shard)
+			: _Shard(shard)
+		{
+		}
+
+		bool TcpServer::Shard::BackoffTimer::OnReady()
+		{
+			uint64_t expirations;
+			if (read(_Shard._TimerFd, &expirations, sizeof(expirations)) < 0 && errno == EAGAIN)
+				return false;
+			_Shard.Start();
+			return true;
+		}
+		void TcpServer::Shard::BackoffTimer::OnError(std::exception_ptr error)
+		{
+			_Shard.OnError(error);
+		}
+
+
+
+		TcpServer::TcpServer(const SocketAddress& addr, size_t shardCount, int backlog, THandler handler)
+			: _Handler(handler)
+			, _Shards()
+			, _Scheduler(new Scheduler(shardCount))
+		{
+			// Bind every listener before any of them starts accepting so that a failure leaves nothing half-started.
+			for (size_t i = 0; i < shardCount; ++i)
+				_Shards.emplace_back(new Shard(*this, (*_Scheduler)[i], addr, backlog));
+			for (auto& shard : _Shards)
+				shard->Start();
+		}
+		TcpServer::~TcpServer()
+		{
+			_Scheduler.reset();
+		}
+
+		size_t TcpServer::ShardCount() const
+		{
+			return _Shards.size();
+		}
+	}
+}
+#endif // _L_LINUX
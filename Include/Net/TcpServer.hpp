@@ -0,0 +1,87 @@
+// File: TcpServer.hpp
+// Author: Rendong Liang (Liong)
+
+#pragma once
+#include "../Fundamental.hpp"
+#include "EventLoop.hpp"
+#include "Socket.hpp"
+#include "SocketAddress.hpp"
+
+#ifdef _L_LINUX
+namespace LiongPlus
+{
+	namespace Net
+	{
+		/*
+		 * A TCP server listening on several SO_REUSEPORT sockets bound to the same address, one per event loop thread. The kernel spreads incoming connections across the listeners, so accepting scales with cores instead of contending on a single queue.
+		 */
+		class TcpServer
+		{
+		public:
+			/*
+			 * Called on the loop thread that accepted the connection. $socket is non-blocking; spawn coroutines on $loop to serve it.
+			 * An exception thrown by the handler is reported and drops only that connection.
+			 */
+			using THandler = Func<void, EventLoop&, Socket, const SocketAddress&>;
+		private:
+			class Shard
+				: public IoWaiter
+			{
+			private:
+				// Waits out a back-off, then puts the listener back into the loop.
+				class BackoffTimer
+					: public IoWaiter
+				{
+				private:
+					Shard& _Shard;
+				public:
+					BackoffTimer(Shard& shard);
+
+					bool OnReady() override;
+					void OnError(std::exception_ptr error) override;
+				};
+
+				// How long a listener rests after it failed or could not shed a connection, instead of spinning on the same error.
+				static const int BACKOFF_MS = 100;
+
+				TcpServer& _Server;
+				EventLoop& _Loop;
+				Socket _Listener;
+				SocketAddress _Peer;
+				// Held open to be given up when descriptors run out, so that a pending connection can still be accepted and closed.
+				int _SpareFd;
+				int _TimerFd;
+				BackoffTimer _Backoff;
+
+				bool Shed();
+				void Backoff();
+			public:
+				Shard(TcpServer& server, EventLoop& loop, const SocketAddress& addr, int backlog);
+				~Shard();
+
+				void Start();
+				bool OnReady() override;
+				/*
+				 * Report $error and start accepting again after a back-off, so that a shard never stops for good.
+				 */
+				void OnError(std::exception_ptr error) override;
+			};
+
+			THandler _Handler;
+			std::vector<std::unique_ptr<Shard>> _Shards;
+			// Declared last so that loop threads are joined before the shards go away.
+			std::unique_ptr<Scheduler> _Scheduler;
+		public:
+			/*
+			 * Open $shardCount listeners on $addr, each served by its own pinned loop thread.
+			 */
+			TcpServer(const SocketAddress& addr, size_t shardCount, int backlog, THandler handler);
+			TcpServer(const TcpServer&) = delete;
+			TcpServer(TcpServer&&) = delete;
+			~TcpServer();
+
+			size_t ShardCount() const;
+		};
+	}
+}
+#endif // _L_LINUX
@@ -9,6 +9,8 @@ namespace LiongPlus
 {
 	/// <summary>
 	/// Help store optional obj which can be nullptr.
+	/// The object is stored inline, so no heap allocation is made. As with std::optional,
+	/// Nullable of a trivially copyable type is itself trivially copyable.
 	/// </summary>
 	/// <typeparam name="T">Type of obj</typeparam>
 	template<typename T>
@@ -16,60 +18,53 @@ namespace LiongPlus
 	{
 	private:
 		typedef Nullable<T> TSelf;
-		
-		bool Equals(TSelf& n1, TSelf& n2)
-		{
-			return
-				n1._Object ?
-				n2._Object ?
-				*n1._Object == *n2._Object
-				: false
-				: n2._Object ?
-				false
-				: true;
-		}
-	protected:
-		T* _Object;
+
+		alignas(T) unsigned char _Storage[sizeof(T)];
+		bool _HasValue;
+
+		T* Object()
+		{
+			return reinterpret_cast<T*>(&_Storage);
+		}
+		const T* Object() const
+		{
+			return reinterpret_cast<const T*>(&_Storage);
+		}
 	public:
 		Nullable()
-			: _Object(nullptr)
+			: _HasValue(false)
 		{
 		}
 		Nullable(nullptr_t)
-			: _Object(nullptr)
+			: _HasValue(false)
 		{
 		}
 		Nullable(const T& obj)
-			: _Object(new T(obj))
+			: _HasValue(true)
 		{
+			new (&_Storage) T(obj);
 		}
 		Nullable(T&& obj)
-			: Nullable()
+			: _HasValue(true)
 		{
-			_Object = new T(std::forward<T>(obj));
+			new (&_Storage) T(std::move(obj));
 		}
-		Nullable(const TSelf& nullable)
-			: _Object(nullptr)
+		Nullable(const TSelf&) requires std::is_trivially_copy_constructible<T>::value = default;
+		Nullable(const TSelf& nullable) requires (!std::is_trivially_copy_constructible<T>::value)
+			: _HasValue(nullable._HasValue)
 		{
-			if (nullable._Object == nullptr)
-			{
-				CleanUp();
-				_Object = nullptr;
-			}
-			else
-			{
-				if (_Object == nullptr)
-					_Object = new T(*nullable._Object);
-				else
-					*_Object = *nullable._Object;
-			}
+			if (_HasValue)
+				new (&_Storage) T(*nullable.Object());
 		}
-		Nullable(TSelf&& nullable)
-			: Nullable()
+		Nullable(TSelf&&) requires std::is_trivially_move_constructible<T>::value = default;
+		Nullable(TSelf&& nullable) requires (!std::is_trivially_move_constructible<T>::value)
+			: _HasValue(nullable._HasValue)
 		{
-			swap(_Object, nullable._Object);
+			if (_HasValue)
+				new (&_Storage) T(std::move(*nullable.Object()));
 		}
-		~Nullable()
+		~Nullable() requires std::is_trivially_destructible<T>::value = default;
+		~Nullable() requires (!std::is_trivially_destructible<T>::value)
 		{
 			CleanUp();
 		}
@@ -77,42 +72,46 @@ namespace LiongPlus
 		TSelf& operator=(nullptr_t)
 		{
 			CleanUp();
+			return *this;
 		}
 		TSelf& operator=(const T& obj)
 		{
-			if (_Object == nullptr)
-				_Object = new T(obj);
+			if (_HasValue)
+				*Object() = obj;
 			else
-				*_Object = obj;
+			{
+				new (&_Storage) T(obj);
+				_HasValue = true;
+			}
 			return *this;
 		}
 		TSelf& operator=(T&& obj)
 		{
-			if (_Object == nullptr)
-				_Object = new T(std::forward<T>(obj));
+			if (_HasValue)
+				*Object() = std::move(obj);
 			else
-				*_Object = obj;
+			{
+				new (&_Storage) T(std::move(obj));
+				_HasValue = true;
+			}
 			return *this;
 		}
-		TSelf& operator=(const TSelf& nullable)
+		TSelf& operator=(const TSelf&) requires std::is_trivially_copyable<T>::value = default;
+		TSelf& operator=(const TSelf& nullable) requires (!std::is_trivially_copyable<T>::value)
 		{
-			if (nullable._Object == nullptr)
-			{
-				CleanUp();
-				_Object = nullptr;
-			}
+			if (nullable._HasValue)
+				*this = *nullable.Object();
 			else
-			{
-				if (_Object == nullptr)
-					_Object = new T(*nullable._Object);
-				else
-					*_Object = *nullable._Object;
-			}
+				CleanUp();
 			return *this;
 		}
-		TSelf& operator=(TSelf&& nullable)
+		TSelf& operator=(TSelf&&) requires std::is_trivially_copyable<T>::value = default;
+		TSelf& operator=(TSelf&& nullable) requires (!std::is_trivially_copyable<T>::value)
 		{
-			swap(_Object, nullable._Object);
+			if (nullable._HasValue)
+				*this = std::move(*nullable.Object());
+			else
+				CleanUp();
 			return *this;
 		}
 
@@ -120,45 +119,64 @@ namespace LiongPlus
 		{
 			return Equals(*this, nullable);
 		}
-		bool operator==(const nullptr_t nullptr) const
+		bool operator==(nullptr_t) const
 		{
-			return _Object == nullptr;
+			return !_HasValue;
 		}
 		bool operator!() const
 		{
-			return _Object == nullptr;
+			return !_HasValue;
 		}
 		bool operator!=(const TSelf& nullable) const
 		{
 			return !Equals(*this, nullable);
 		}
+		bool operator!=(nullptr_t) const
+		{
+			return _HasValue;
+		}
 
 		operator bool() const
 		{
-			return _Object != nullptr;
+			return _HasValue;
+		}
+
+		static bool Equals(const TSelf& n1, const TSelf& n2)
+		{
+			if (n1._HasValue != n2._HasValue)
+				return false;
+			return !n1._HasValue || *n1.Object() == *n2.Object();
 		}
 
 		void CleanUp()
 		{
-			if (_Object != nullptr)
+			if (_HasValue)
 			{
-				delete _Object;
-				_Object = nullptr;
+				Object()->~T();
+				_HasValue = false;
 			}
 		}
 
-		T& GetValueOrDefault(T& defaultValue) const
+		T& GetValueOrDefault(T& defaultValue)
 		{
-			return _Object != nullptr ? *_Object : defaultValue;
+			return _HasValue ? *Object() : defaultValue;
+		}
+		const T& GetValueOrDefault(const T& defaultValue) const
+		{
+			return _HasValue ? *Object() : defaultValue;
 		}
 		bool HasValue() const
 		{
-			return _Object != nullptr;
+			return _HasValue;
+		}
+		T& Value()
+		{
+			return *Object();
 		}
-		T& Value() const
+		const T& Value() const
 		{
-			return *_Object;
+			return *Object();
 		}
 	};
 }
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,90 @@
+// File: CoalescingProgress.hpp
+// Author: Rendong Liang (Liong)
+
+#ifndef _L_CoalescingProgress
+#define _L_CoalescingProgress
+#include "../Fundamental.hpp"
+#include "../IProgress.hpp"
+#include "TimerQueue.hpp"
+
+namespace LiongPlus
+{
+	namespace Reactive
+	{
+		/*
+		 * A progress sink that workers can report to as often as they like.
+		 * Report() only stores the value; a timer publishes the latest one at most once every interval, and only if it moved by at least a minimal step since the last publication. Reports in between are coalesced away.
+		 * Workers holding the concrete type get Report() inlined down to one relaxed atomic store.
+		 */
+		template<typename T>
+		class CoalescingProgress final
+			: public IProgress<T>
+		{
+			static_assert(std::is_arithmetic<T>::value, "Progress must be a number.");
+		private:
+			std::atomic<T> _Latest;
+			T _Published;
+			T _MinStep;
+			Action<T> _Publish;
+			TimerQueue& _Timers;
+			TimerQueue::TId _Timer;
+
+			bool ShouldPublish(T value) const
+			{
+				if (value == _Published)
+					return false;
+				auto step = value > _Published ? value - _Published : _Published - value;
+				return step >= _MinStep;
+			}
+			/*
+			 * Publish the latest progress. Unless $force is true, it is skipped if it has not moved far enough.
+			 */
+			void Flush(bool force)
+			{
+				auto value = _Latest.load(std::memory_order_relaxed);
+				if (force ? value == _Published : !ShouldPublish(value))
+					return;
+				_Published = value;
+				_Publish(value);
+			}
+		public:
+			/*
+			 * [param] $publish Receives progress on the timer thread.
+			 * [param] $interval Minimal interval between publications.
+			 * [param] $minStep Minimal change worth publishing, e.g. 0.01 for 1% if progress is reported as a fraction.
+			 * [param] $initial Progress considered already published.
+			 */
+			CoalescingProgress(Action<T> publish, std::chrono::steady_clock::duration interval, T minStep = T(), T initial = T(), TimerQueue& timers = TimerQueue::Default())
+				: _Latest(initial)
+				, _Published(initial)
+				, _MinStep(minStep)
+				, _Publish(std::move(publish))
+				, _Timers(timers)
+				, _Timer(0)
+			{
+				_Timer = _Timers.Schedule(interval, [this] { Flush(false); });
+			}
+			CoalescingProgress(const CoalescingProgress<T>&) = delete;
+			CoalescingProgress(CoalescingProgress<T>&&) = delete;
+			/*
+			 * Stop the timer and publish the final progress if it has not been.
+			 */
+			~CoalescingProgress()
+			{
+				_Timers.Cancel(_Timer);
+				Flush(true);
+			}
+
+			void Report(T value) override
+			{
+				_Latest.store(value, std::memory_order_relaxed);
+			}
+
+			T Latest() const
+			{
+				return _Latest.load(std::memory_order_relaxed);
+			}
+		};
+	}
+}
+#endif
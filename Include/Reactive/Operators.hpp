@@ -0,0 +1,619 @@
+// File: Operators.hpp
+// Author: Rendong Liang (Liong)
+
+#ifndef _L_Operators
+#define _L_Operators
+#include "../Fundamental.hpp"
+#include "../IObservable.hpp"
+#include "../IObserver.hpp"
+#include "../Nullable.hpp"
+#include "Subject.hpp"
+#include "TimerQueue.hpp"
+
+namespace LiongPlus
+{
+	namespace Reactive
+	{
+		namespace Detail
+		{
+			template<typename T>
+			void EmitBatch(IObserver<T>& observer, const std::vector<T>& batch)
+			{
+				if (!batch.empty())
+					observer.OnNextBatch(batch.data(), batch.size());
+			}
+			// std::vector<bool> has no contiguous storage to hand out.
+			inline void EmitBatch(IObserver<bool>& observer, const std::vector<bool>& batch)
+			{
+				for (bool value : batch)
+					observer.OnNext(value);
+			}
+
+			/*
+			 * Wrap the subscription to $source so that disposing it also keeps $source alive until then and runs $onDispose afterwards.
+			 */
+			template<typename TSource>
+			Subscription Chain(const std::shared_ptr<TSource>& source, Subscription upstream, Action<> onDispose)
+			{
+				auto shared = std::make_shared<Subscription>(std::move(upstream));
+				return Subscription([source, shared, onDispose]
+				{
+					shared->Dispose();
+					if (onDispose)
+						onDispose();
+				});
+			}
+
+			template<typename TSource, typename TFunc>
+			using TMapResult = typename std::decay<decltype(std::declval<TFunc&>()(std::declval<const typename TSource::TValue&>()))>::type;
+
+
+
+			template<typename TIn, typename TOut>
+			class OperatorObserver
+				: public IObserver<TIn>
+			{
+			protected:
+				std::shared_ptr<IObserver<TOut>> _Downstream;
+			public:
+				OperatorObserver(std::shared_ptr<IObserver<TOut>> downstream)
+					: _Downstream(std::move(downstream))
+				{
+				}
+
+				void OnCompleted() override
+				{
+					_Downstream->OnCompleted();
+				}
+				void OnError(std::exception_ptr e) override
+				{
+					_Downstream->OnError(e);
+				}
+			};
+
+
+
+			template<typename T, typename U, typename TFunc>
+			class MapObserver
+				: public OperatorObserver<T, U>
+			{
+			private:
+				TFunc _Func;
+				std::vector<U> _Batch;
+			public:
+				MapObserver(std::shared_ptr<IObserver<U>> downstream, TFunc func)
+					: OperatorObserver<T, U>(std::move(downstream))
+					, _Func(std::move(func))
+					, _Batch()
+				{
+				}
+
+				void OnNext(const T& value) override
+				{
+					this->_Downstream->OnNext(_Func(value));
+				}
+				void OnNextBatch(const T* values, size_t count) override
+				{
+					_Batch.clear();
+					for (size_t i = 0; i < count; ++i)
+						_Batch.push_back(_Func(values[i]));
+					EmitBatch(*this->_Downstream, _Batch);
+				}
+			};
+
+
+
+			template<typename T, typename TFunc>
+			class FilterObserver
+				: public OperatorObserver<T, T>
+			{
+			private:
+				TFunc _Predicate;
+				std::vector<T> _Batch;
+			public:
+				FilterObserver(std::shared_ptr<IObserver<T>> downstream, TFunc predicate)
+					: OperatorObserver<T, T>(std::move(downstream))
+					, _Predicate(std::move(predicate))
+					, _Batch()
+				{
+				}
+
+				void OnNext(const T& value) override
+				{
+					if (_Predicate(value))
+						this->_Downstream->OnNext(value);
+				}
+				void OnNextBatch(const T* values, size_t count) override
+				{
+					_Batch.clear();
+					for (size_t i = 0; i < count; ++i)
+					{
+						if (_Predicate(values[i]))
+							_Batch.push_back(values[i]);
+					}
+					EmitBatch(*this->_Downstream, _Batch);
+				}
+			};
+
+
+
+			template<typename T>
+			class BufferCountObserver
+				: public OperatorObserver<T, std::vector<T>>
+			{
+			private:
+				size_t _Count;
+				std::vector<T> _Buffer;
+
+				void Flush()
+				{
+					std::vector<T> batch;
+					batch.reserve(_Count);
+					std::swap(batch, _Buffer);
+					this->_Downstream->OnNext(batch);
+				}
+			public:
+				BufferCountObserver(std::shared_ptr<IObserver<std::vector<T>>> downstream, size_t count)
+					: OperatorObserver<T, std::vector<T>>(std::move(downstream))
+					, _Count(count)
+					, _Buffer()
+				{
+					_Buffer.reserve(count);
+				}
+
+				void OnCompleted() override
+				{
+					if (!_Buffer.empty())
+						Flush();
+					this->_Downstream->OnCompleted();
+				}
+				void OnNext(const T& value) override
+				{
+					_Buffer.push_back(value);
+					if (_Buffer.size() >= _Count)
+						Flush();
+				}
+				void OnNextBatch(const T* values, size_t count) override
+				{
+					while (count > 0)
+					{
+						auto n = std::min(count, _Count - _Buffer.size());
+						_Buffer.insert(_Buffer.end(), values, values + n);
+						values += n;
+						count -= n;
+						if (_Buffer.size() >= _Count)
+							Flush();
+					}
+				}
+			};
+
+
+
+			/*
+			 * Base of operators flushed by a timer. Values are collected under $_Mutex, while $_EmitMutex keeps the timer and the completion from notifying downstream at the same time.
+			 */
+			template<typename T, typename TOut>
+			class TimedObserver
+				: public OperatorObserver<T, TOut>
+			{
+			protected:
+				std::mutex _Mutex;
+				std::mutex _EmitMutex;
+				bool _IsStopped;
+
+				/*
+				 * [return] True if something was taken into $out. Called with $_Mutex locked.
+				 */
+				virtual bool Take(TOut& out) = 0;
+			public:
+				TimedObserver(std::shared_ptr<IObserver<TOut>> downstream)
+					: OperatorObserver<T, TOut>(std::move(downstream))
+					, _Mutex()
+					, _EmitMutex()
+					, _IsStopped(false)
+				{
+				}
+
+				void Tick()
+				{
+					std::lock_guard<std::mutex> emitLock(_EmitMutex);
+					TOut out;
+					{
+						std::lock_guard<std::mutex> lock(_Mutex);
+						if (_IsStopped || !Take(out))
+							return;
+					}
+					this->_Downstream->OnNext(out);
+				}
+
+				void OnCompleted() override
+				{
+					std::lock_guard<std::mutex> emitLock(_EmitMutex);
+					TOut out;
+					bool hasOut;
+					{
+						std::lock_guard<std::mutex> lock(_Mutex);
+						if (_IsStopped)
+							return;
+						_IsStopped = true;
+						hasOut = Take(out);
+					}
+					if (hasOut)
+						this->_Downstream->OnNext(out);
+					this->_Downstream->OnCompleted();
+				}
+				void OnError(std::exception_ptr e) override
+				{
+					std::lock_guard<std::mutex> emitLock(_EmitMutex);
+					{
+						std::lock_guard<std::mutex> lock(_Mutex);
+						if (_IsStopped)
+							return;
+						_IsStopped = true;
+					}
+					this->_Downstream->OnError(e);
+				}
+			};
+
+
+
+			template<typename T>
+			class BufferTimeObserver
+				: public TimedObserver<T, std::vector<T>>
+			{
+			private:
+				std::vector<T> _Buffer;
+			protected:
+				bool Take(std::vector<T>& out) override
+				{
+					if (_Buffer.empty())
+						return false;
+					std::swap(out, _Buffer);
+					// Guess the next window is as large as this one.
+					_Buffer.reserve(out.size());
+					return true;
+				}
+			public:
+				BufferTimeObserver(std::shared_ptr<IObserver<std::vector<T>>> downstream)
+					: TimedObserver<T, std::vector<T>>(std::move(downstream))
+					, _Buffer()
+				{
+				}
+
+				void OnNext(const T& value) override
+				{
+					std::lock_guard<std::mutex> lock(this->_Mutex);
+					if (!this->_IsStopped)
+						_Buffer.push_back(value);
+				}
+				void OnNextBatch(const T* values, size_t count) override
+				{
+					std::lock_guard<std::mutex> lock(this->_Mutex);
+					if (!this->_IsStopped)
+						_Buffer.insert(_Buffer.end(), values, values + count);
+				}
+			};
+
+
+
+			template<typename T>
+			class SampleObserver
+				: public TimedObserver<T, T>
+			{
+			private:
+				Nullable<T> _Latest;
+			protected:
+				bool Take(T& out) override
+				{
+					if (!_Latest.HasValue())
+						return false;
+					out = std::move(_Latest.Value());
+					_Latest = nullptr;
+					return true;
+				}
+			public:
+				SampleObserver(std::shared_ptr<IObserver<T>> downstream)
+					: TimedObserver<T, T>(std::move(downstream))
+					, _Latest()
+				{
+				}
+
+				void OnNext(const T& value) override
+				{
+					std::lock_guard<std::mutex> lock(this->_Mutex);
+					if (!this->_IsStopped)
+						_Latest = value;
+				}
+				void OnNextBatch(const T* values, size_t count) override
+				{
+					if (count == 0)
+						return;
+					std::lock_guard<std::mutex> lock(this->_Mutex);
+					if (!this->_IsStopped)
+						_Latest = values[count - 1];
+				}
+			};
+
+
+
+			template<typename T>
+			class ThrottleObserver
+				: public OperatorObserver<T, T>
+			{
+			private:
+				std::chrono::steady_clock::duration _Period;
+				std::chrono::steady_clock::time_point _NextAllowed;
+			public:
+				ThrottleObserver(std::shared_ptr<IObserver<T>> downstream, std::chrono::steady_clock::duration period)
+					: OperatorObserver<T, T>(std::move(downstream))
+					, _Period(period)
+					, _NextAllowed()
+				{
+				}
+
+				void OnNext(const T& value) override
+				{
+					auto now = std::chrono::steady_clock::now();
+					if (now < _NextAllowed)
+						return;
+					_NextAllowed = now + _Period;
+					this->_Downstream->OnNext(value);
+				}
+				void OnNextBatch(const T* values, size_t count) override
+				{
+					// A batch arrives at a single moment, so at most its first value passes.
+					if (count > 0)
+						OnNext(values[0]);
+				}
+			};
+
+
+
+			/*
+			 * Hands values over to a thread of its own through a bounded queue. Producers block while the queue is full, and the consumer passes everything queued downstream in one batch.
+			 */
+			template<typename T>
+			class QueueObserver
+				: public OperatorObserver<T, T>
+			{
+			private:
+				std::mutex _Mutex;
+				std::condition_variable _NotEmpty, _NotFull;
+				std::vector<T> _Pending;
+				size_t _Capacity;
+				bool _IsCompleted, _IsDisposed;
+				std::exception_ptr _Error;
+				std::thread _Thread;
+
+				void Drain()
+				{
+					std::vector<T> batch;
+					batch.reserve(_Capacity);
+					while (true)
+					{
+						bool isCompleted;
+						std::exception_ptr error;
+						{
+							std::unique_lock<std::mutex> lock(_Mutex);
+							_NotEmpty.wait(lock, [this] { return !_Pending.empty() || _IsCompleted || _IsDisposed; });
+							if (_IsDisposed)
+								return;
+							// Swapping keeps both buffers' capacity, so nothing is allocated in steady state.
+							std::swap(batch, _Pending);
+							isCompleted = _IsCompleted;
+							error = _Error;
+						}
+						// The whole queue was freed, so every blocked producer may proceed.
+						_NotFull.notify_all();
+
+						EmitBatch(*this->_Downstream, batch);
+						batch.clear();
+						// Completion is never queued before values, so everything has been delivered by now.
+						if (isCompleted)
+						{
+							if (error)
+								this->_Downstream->OnError(error);
+							else
+								this->_Downstream->OnCompleted();
+							return;
+						}
+					}
+				}
+			public:
+				QueueObserver(std::shared_ptr<IObserver<T>> downstream, size_t capacity)
+					: OperatorObserver<T, T>(std::move(downstream))
+					, _Mutex()
+					, _NotEmpty()
+					, _NotFull()
+					, _Pending()
+					, _Capacity(capacity)
+					, _IsCompleted(false)
+					, _IsDisposed(false)
+					, _Error(nullptr)
+					, _Thread()
+				{
+					if (capacity == 0)
+						throw std::runtime_error("Invalid $capacity.");
+					_Pending.reserve(capacity);
+				}
+
+				/*
+				 * Start the consumer thread. It keeps $self alive until it exits.
+				 */
+				void Start(std::shared_ptr<QueueObserver<T>> self)
+				{
+					_Thread = std::thread([self] { self->Drain(); });
+				}
+				/*
+				 * Stop the consumer thread. Values still queued are dropped.
+				 */
+				void Stop()
+				{
+					{
+						std::lock_guard<std::mutex> lock(_Mutex);
+						_IsDisposed = true;
+					}
+					_NotEmpty.notify_all();
+					_NotFull.notify_all();
+					if (std::this_thread::get_id() == _Thread.get_id())
+						_Thread.detach();
+					else if (_Thread.joinable())
+						_Thread.join();
+				}
+
+				void OnCompleted() override
+				{
+					{
+						std::lock_guard<std::mutex> lock(_Mutex);
+						_IsCompleted = true;
+					}
+					_NotEmpty.notify_one();
+				}
+				void OnError(std::exception_ptr e) override
+				{
+					{
+						std::lock_guard<std::mutex> lock(_Mutex);
+						_Error = e;
+						_IsCompleted = true;
+					}
+					_NotEmpty.notify_one();
+				}
+				void OnNext(const T& value) override
+				{
+					OnNextBatch(&value, 1);
+				}
+				void OnNextBatch(const T* values, size_t count) override
+				{
+					while (count > 0)
+					{
+						bool wasEmpty;
+						{
+							std::unique_lock<std::mutex> lock(_Mutex);
+							_NotFull.wait(lock, [this] { return _Pending.size() < _Capacity || _IsDisposed; });
+							if (_IsDisposed || _IsCompleted)
+								return;
+							wasEmpty = _Pending.empty();
+							auto n = std::min(count, _Capacity - _Pending.size());
+							_Pending.insert(_Pending.end(), values, values + n);
+							values += n;
+							count -= n;
+						}
+						// The consumer only sleeps on an empty queue.
+						if (wasEmpty)
+							_NotEmpty.notify_one();
+					}
+				}
+			};
+		}
+
+		/*
+		 * Operators below take any observable by shared pointer and return a new one. Subscribing to the result subscribes to $source, which is kept alive until the subscription is disposed.
+		 * Batches received through OnNextBatch() stay batches through Map and Filter, so a pipeline behind Queue costs a virtual call per batch rather than per value.
+		 */
+
+		/*
+		 * Transform each value with $func.
+		 */
+		template<typename TSource, typename TFunc>
+		std::shared_ptr<IObservable<Detail::TMapResult<TSource, TFunc>>> Map(std::shared_ptr<TSource> source, TFunc func)
+		{
+			typedef typename TSource::TValue T;
+			typedef Detail::TMapResult<TSource, TFunc> U;
+			return std::make_shared<AnonymousObservable<U>>([source, func](std::shared_ptr<IObserver<U>> downstream)
+			{
+				auto observer = std::make_shared<Detail::MapObserver<T, U, TFunc>>(std::move(downstream), func);
+				return Detail::Chain(source, source->Subscribe(observer), nullptr);
+			});
+		}
+
+		/*
+		 * Pass on only values $predicate returns true for.
+		 */
+		template<typename TSource, typename TFunc>
+		std::shared_ptr<IObservable<typename TSource::TValue>> Filter(std::shared_ptr<TSource> source, TFunc predicate)
+		{
+			typedef typename TSource::TValue T;
+			return std::make_shared<AnonymousObservable<T>>([source, predicate](std::shared_ptr<IObserver<T>> downstream)
+			{
+				auto observer = std::make_shared<Detail::FilterObserver<T, TFunc>>(std::move(downstream), predicate);
+				return Detail::Chain(source, source->Subscribe(observer), nullptr);
+			});
+		}
+
+		/*
+		 * Group values into vectors of $count. The last one may be shorter.
+		 */
+		template<typename TSource>
+		std::shared_ptr<IObservable<std::vector<typename TSource::TValue>>> Buffer(std::shared_ptr<TSource> source, size_t count)
+		{
+			typedef typename TSource::TValue T;
+			if (count == 0)
+				throw std::runtime_error("Invalid $count.");
+			return std::make_shared<AnonymousObservable<std::vector<T>>>([source, count](std::shared_ptr<IObserver<std::vector<T>>> downstream)
+			{
+				auto observer = std::make_shared<Detail::BufferCountObserver<T>>(std::move(downstream), count);
+				return Detail::Chain(source, source->Subscribe(observer), nullptr);
+			});
+		}
+
+		/*
+		 * Group values received during each $period into a vector. Empty periods are skipped.
+		 */
+		template<typename TSource>
+		std::shared_ptr<IObservable<std::vector<typename TSource::TValue>>> Buffer(std::shared_ptr<TSource> source, std::chrono::steady_clock::duration period, TimerQueue& timers = TimerQueue::Default())
+		{
+			typedef typename TSource::TValue T;
+			return std::make_shared<AnonymousObservable<std::vector<T>>>([source, period, &timers](std::shared_ptr<IObserver<std::vector<T>>> downstream)
+			{
+				auto observer = std::make_shared<Detail::BufferTimeObserver<T>>(std::move(downstream));
+				auto id = timers.Schedule(period, [observer] { observer->Tick(); });
+				return Detail::Chain(source, source->Subscribe(observer), [&timers, id] { timers.Cancel(id); });
+			});
+		}
+
+		/*
+		 * Pass on the latest value once every $period, if there is a new one. The value pending on completion is passed on as well.
+		 */
+		template<typename TSource>
+		std::shared_ptr<IObservable<typename TSource::TValue>> Sample(std::shared_ptr<TSource> source, std::chrono::steady_clock::duration period, TimerQueue& timers = TimerQueue::Default())
+		{
+			typedef typename TSource::TValue T;
+			return std::make_shared<AnonymousObservable<T>>([source, period, &timers](std::shared_ptr<IObserver<T>> downstream)
+			{
+				auto observer = std::make_shared<Detail::SampleObserver<T>>(std::move(downstream));
+				auto id = timers.Schedule(period, [observer] { observer->Tick(); });
+				return Detail::Chain(source, source->Subscribe(observer), [&timers, id] { timers.Cancel(id); });
+			});
+		}
+
+		/*
+		 * Pass on a value, then drop everything in the following $period.
+		 */
+		template<typename TSource>
+		std::shared_ptr<IObservable<typename TSource::TValue>> Throttle(std::shared_ptr<TSource> source, std::chrono::steady_clock::duration period)
+		{
+			typedef typename TSource::TValue T;
+			return std::make_shared<AnonymousObservable<T>>([source, period](std::shared_ptr<IObserver<T>> downstream)
+			{
+				auto observer = std::make_shared<Detail::ThrottleObserver<T>>(std::move(downstream), period);
+				return Detail::Chain(source, source->Subscribe(observer), nullptr);
+			});
+		}
+
+		/*
+		 * Deliver values on a dedicated thread, in batches of at most $capacity. When $capacity values are waiting, the producer blocks until the consumer catches up.
+		 */
+		template<typename TSource>
+		std::shared_ptr<IObservable<typename TSource::TValue>> Queue(std::shared_ptr<TSource> source, size_t capacity)
+		{
+			typedef typename TSource::TValue T;
+			return std::make_shared<AnonymousObservable<T>>([source, capacity](std::shared_ptr<IObserver<T>> downstream)
+			{
+				auto observer = std::make_shared<Detail::QueueObserver<T>>(std::move(downstream), capacity);
+				observer->Start(observer);
+				return Detail::Chain(source, source->Subscribe(observer), [observer] { observer->Stop(); });
+			});
+		}
+	}
+}
+#endif
@@ -0,0 +1,182 @@
+// File: Subject.hpp
+// Author: Rendong Liang (Liong)
+
+#ifndef _L_Subject
+#define _L_Subject
+#include "../Fundamental.hpp"
+#include "../IObservable.hpp"
+#include "../IObserver.hpp"
+
+namespace LiongPlus
+{
+	namespace Reactive
+	{
+		/*
+		 * Both an observer and an observable. Everything it observes is pushed to all of its subscribers.
+		 * Notifications should come from one thread at a time, as for any observer. Subscriptions must not outlive the subject.
+		 */
+		template<typename T>
+		class Subject
+			: public IObservable<T>
+			, public IObserver<T>
+		{
+		private:
+			typedef std::vector<std::shared_ptr<IObserver<T>>> TObservers;
+
+			std::mutex _Mutex;
+			// Replaced rather than modified on (un)subscription, so notifying only needs a snapshot.
+			std::shared_ptr<const TObservers> _Observers;
+			bool _IsStopped;
+
+			std::shared_ptr<const TObservers> Snapshot()
+			{
+				std::lock_guard<std::mutex> lock(_Mutex);
+				return _Observers;
+			}
+			std::shared_ptr<const TObservers> Stop()
+			{
+				std::lock_guard<std::mutex> lock(_Mutex);
+				_IsStopped = true;
+				auto observers = std::move(_Observers);
+				_Observers = std::make_shared<const TObservers>();
+				return observers;
+			}
+			void Unsubscribe(const std::shared_ptr<IObserver<T>>& observer)
+			{
+				std::lock_guard<std::mutex> lock(_Mutex);
+				auto observers = std::make_shared<TObservers>(*_Observers);
+				auto pos = std::find(observers->begin(), observers->end(), observer);
+				if (pos != observers->end())
+				{
+					observers->erase(pos);
+					_Observers = observers;
+				}
+			}
+		public:
+			Subject()
+				: _Mutex()
+				, _Observers(std::make_shared<const TObservers>())
+				, _IsStopped(false)
+			{
+			}
+			Subject(const Subject<T>&) = delete;
+			Subject(Subject<T>&&) = delete;
+
+			Subscription Subscribe(std::shared_ptr<IObserver<T>> observer) override
+			{
+				{
+					std::lock_guard<std::mutex> lock(_Mutex);
+					if (!_IsStopped)
+					{
+						auto observers = std::make_shared<TObservers>(*_Observers);
+						observers->push_back(observer);
+						_Observers = observers;
+						return Subscription([this, observer] { Unsubscribe(observer); });
+					}
+				}
+				observer->OnCompleted();
+				return Subscription();
+			}
+
+			void OnCompleted() override
+			{
+				auto observers = Stop();
+				for (auto& observer : *observers)
+					observer->OnCompleted();
+			}
+			void OnError(std::exception_ptr e) override
+			{
+				auto observers = Stop();
+				for (auto& observer : *observers)
+					observer->OnError(e);
+			}
+			void OnNext(const T& value) override
+			{
+				auto observers = Snapshot();
+				for (auto& observer : *observers)
+					observer->OnNext(value);
+			}
+			void OnNextBatch(const T* values, size_t count) override
+			{
+				if (count == 0)
+					return;
+				auto observers = Snapshot();
+				for (auto& observer : *observers)
+					observer->OnNextBatch(values, count);
+			}
+
+			bool HasObservers()
+			{
+				return !Snapshot()->empty();
+			}
+		};
+
+
+
+		/*
+		 * An observer made of functors. Any of them can be empty.
+		 */
+		template<typename T>
+		class AnonymousObserver
+			: public IObserver<T>
+		{
+		private:
+			Action<const T&> _OnNext;
+			Action<std::exception_ptr> _OnError;
+			Action<> _OnCompleted;
+		public:
+			AnonymousObserver(Action<const T&> onNext, Action<std::exception_ptr> onError, Action<> onCompleted)
+				: _OnNext(std::move(onNext))
+				, _OnError(std::move(onError))
+				, _OnCompleted(std::move(onCompleted))
+			{
+			}
+
+			void OnCompleted() override
+			{
+				if (_OnCompleted)
+					_OnCompleted();
+			}
+			void OnError(std::exception_ptr e) override
+			{
+				if (_OnError)
+					_OnError(e);
+			}
+			void OnNext(const T& value) override
+			{
+				if (_OnNext)
+					_OnNext(value);
+			}
+		};
+
+		template<typename T>
+		std::shared_ptr<IObserver<T>> MakeObserver(Action<const T&> onNext, Action<std::exception_ptr> onError = nullptr, Action<> onCompleted = nullptr)
+		{
+			return std::make_shared<AnonymousObserver<T>>(std::move(onNext), std::move(onError), std::move(onCompleted));
+		}
+
+
+
+		/*
+		 * An observable that runs a functor for each subscription.
+		 */
+		template<typename T>
+		class AnonymousObservable
+			: public IObservable<T>
+		{
+		private:
+			Func<Subscription, std::shared_ptr<IObserver<T>>> _Subscribe;
+		public:
+			AnonymousObservable(Func<Subscription, std::shared_ptr<IObserver<T>>> subscribe)
+				: _Subscribe(std::move(subscribe))
+			{
+			}
+
+			Subscription Subscribe(std::shared_ptr<IObserver<T>> observer) override
+			{
+				return _Subscribe(std::move(observer));
+			}
+		};
+	}
+}
+#endif
@@ -0,0 +1,132 @@
+// File: TimerQueue.cpp
+// Author: Rendong Liang (Liong)
+#include "TimerQueue.hpp"
+
+namespace LiongPlus
+{
+	namespace Reactive
+	{
+		using namespace std::chrono;
+
+		TimerQueue::TimerQueue()
+			: _Mutex()
+			, _Cond()
+			, _Timers()
+			, _Queue()
+			, _NextId(1)
+			, _Running(0)
+			, _IsRunningCancelled(false)
+			, _ShouldExit(false)
+			, _Thread()
+		{
+			_Thread = std::thread([this] { Work(); });
+		}
+		TimerQueue::~TimerQueue()
+		{
+			{
+				std::lock_guard<std::mutex> lock(_Mutex);
+				_ShouldExit = true;
+			}
+			_Cond.notify_all();
+			_Thread.join();
+		}
+
+		TimerQueue::TId TimerQueue::Schedule(steady_clock::duration period, Action<> callback)
+		{
+			if (period <= steady_clock::duration::zero())
+				throw std::runtime_error("Invalid $period.");
+
+			std::lock_guard<std::mutex> lock(_Mutex);
+			auto id = _NextId++;
+			auto& timer = _Timers[id];
+			timer.Callback = std::move(callback);
+			timer.Period = period;
+			timer.Due = steady_clock::now() + period;
+			// Only a new earliest timer changes how long the worker should sleep. Inserted first, as begin() must not be taken before.
+			auto position = _Queue.insert(std::make_pair(timer.Due, id)).first;
+			if (position == _Queue.begin())
+				_Cond.notify_all();
+			return id;
+		}
+
+		void TimerQueue::Cancel(TId id)
+		{
+			std::unique_lock<std::mutex> lock(_Mutex);
+			auto timer = _Timers.find(id);
+			if (timer == _Timers.end())
+				return;
+			_Queue.erase(std::make_pair(timer->second.Due, id));
+			if (_Running == id)
+			{
+				// The worker has already dequeued it; keep it from being rescheduled once the callback returns.
+				_IsRunningCancelled = true;
+				// Cancelled from within its own callback, which is still running. Let the worker erase it afterwards.
+				if (std::this_thread::get_id() == _Thread.get_id())
+					return;
+				_Cond.wait(lock, [this, id] { return _Running != id; });
+			}
+			// The worker erases a timer cancelled while running, but one rescheduled just before may still be queued.
+			timer = _Timers.find(id);
+			if (timer != _Timers.end())
+			{
+				_Queue.erase(std::make_pair(timer->second.Due, id));
+				_Timers.erase(timer);
+			}
+		}
+
+		TimerQueue& TimerQueue::Default()
+		{
+			static TimerQueue queue;
+			return queue;
+		}
+
+		// Private
+
+		void TimerQueue::Work()
+		{
+			std::unique_lock<std::mutex> lock(_Mutex);
+			while (!_ShouldExit)
+			{
+				if (_Queue.empty())
+				{
+					_Cond.wait(lock);
+					continue;
+				}
+				auto next = *_Queue.begin();
+				if (next.first > steady_clock::now())
+				{
+					_Cond.wait_until(lock, next.first);
+					continue;
+				}
+				_Queue.erase(_Queue.begin());
+				auto timer = _Timers.find(next.second);
+				if (timer == _Timers.end())
+					continue;
+
+				// Cancel() from other threads waits for _Running to change before erasing the timer, so the callback stays valid while unlocked.
+				_Running = next.second;
+				auto& callback = timer->second.Callback;
+				lock.unlock();
+				callback();
+				lock.lock();
+				_Running = 0;
+
+				if (_IsRunningCancelled)
+				{
+					_IsRunningCancelled = false;
+					_Timers.erase(timer);
+				}
+				else
+				{
+					// Skip missed periods rather than firing them back to back.
+					auto now = steady_clock::now();
+					timer->second.Due += timer->second.Period;
+					if (timer->second.Due < now)
+						timer->second.Due = now + timer->second.Period;
+					_Queue.insert(std::make_pair(timer->second.Due, next.second));
+				}
+				_Cond.notify_all();
+			}
+		}
+	}
+}
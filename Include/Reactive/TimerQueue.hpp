@@ -0,0 +1,59 @@
+// File: TimerQueue.hpp
+// Author: Rendong Liang (Liong)
+
+#ifndef _L_TimerQueue
+#define _L_TimerQueue
+#include "../Fundamental.hpp"
+
+namespace LiongPlus
+{
+	namespace Reactive
+	{
+		/*
+		 * Runs periodic callbacks on a single background thread.
+		 * Callbacks should be short; a slow one delays every other timer of the queue.
+		 */
+		class TimerQueue
+		{
+		public:
+			typedef uint64_t TId;
+		private:
+			struct Timer
+			{
+				Action<> Callback;
+				std::chrono::steady_clock::duration Period;
+				std::chrono::steady_clock::time_point Due;
+			};
+
+			std::mutex _Mutex;
+			std::condition_variable _Cond;
+			std::map<TId, Timer> _Timers;
+			std::set<std::pair<std::chrono::steady_clock::time_point, TId>> _Queue;
+			TId _NextId;
+			TId _Running;
+			bool _IsRunningCancelled;
+			bool _ShouldExit;
+			std::thread _Thread;
+
+			void Work();
+		public:
+			TimerQueue();
+			TimerQueue(const TimerQueue&) = delete;
+			TimerQueue(TimerQueue&&) = delete;
+			~TimerQueue();
+
+			/*
+			 * Call $callback every $period, first one $period from now.
+			 * [return] Id used to cancel the timer.
+			 */
+			TId Schedule(std::chrono::steady_clock::duration period, Action<> callback);
+			/*
+			 * Stop the timer of $id. When this returns the callback is not running and will not run again, unless this is called from within the callback itself.
+			 */
+			void Cancel(TId id);
+
+			static TimerQueue& Default();
+		};
+	}
+}
+#endif
@@ -0,0 +1,101 @@
+// File: SharedBuffer.cpp
+// Author: Rendong Liang (Liong)
+
+#include "SharedBuffer.hpp"
+
+namespace LiongPlus
+{
+	SharedBuffer::SharedBuffer()
+		: _Block(nullptr)
+	{
+	}
+	SharedBuffer::SharedBuffer(const SharedBuffer& instance)
+		: _Block(instance._Block)
+	{
+		// Relaxed is enough: the new reference is made from an existing one, which keeps the block alive.
+		if (_Block != nullptr)
+			_Block->RefCount.fetch_add(1, std::memory_order_relaxed);
+	}
+	SharedBuffer::SharedBuffer(SharedBuffer&& instance)
+		: _Block(nullptr)
+	{
+		swap(*this, instance);
+	}
+	SharedBuffer::SharedBuffer(Buffer&& buffer)
+		: _Block(new Block{ { 1 }, std::move(buffer) })
+	{
+	}
+	SharedBuffer::~SharedBuffer()
+	{
+		Release();
+	}
+
+	SharedBuffer& SharedBuffer::operator=(const SharedBuffer& instance)
+	{
+		SharedBuffer copy(instance);
+		swap(*this, copy);
+		return *this;
+	}
+	SharedBuffer& SharedBuffer::operator=(SharedBuffer&& instance)
+	{
+		swap(*this, instance);
+		return *this;
+	}
+	Byte SharedBuffer::operator[](size_t index) const
+	{
+		if (index < Length())
+			return _Block->Content.Field()[index];
+		else throw std::runtime_error("$index is out of range.");
+	}
+
+	const Byte* SharedBuffer::Field() const
+	{
+		return _Block != nullptr ? _Block->Content.Field() : nullptr;
+	}
+	size_t SharedBuffer::Length() const
+	{
+		return _Block != nullptr ? _Block->Content.Length() : 0;
+	}
+	bool SharedBuffer::IsEmpty() const
+	{
+		return Length() == 0;
+	}
+	bool SharedBuffer::IsUnique() const
+	{
+		return _Block != nullptr && _Block->RefCount.load(std::memory_order_acquire) == 1;
+	}
+
+	Buffer SharedBuffer::Clone(Memory::MemoryResource* resource) const
+	{
+		return _Block != nullptr ? _Block->Content.Clone(resource) : Buffer();
+	}
+
+	Byte* SharedBuffer::MutableField()
+	{
+		if (_Block == nullptr)
+			return nullptr;
+		if (!IsUnique())
+			*this = SharedBuffer(_Block->Content.Clone(_Block->Content.Resource()));
+		return _Block->Content.Field();
+	}
+
+	Buffer SharedBuffer::Detach()
+	{
+		if (_Block == nullptr)
+			return Buffer();
+		// Copies stay on the resource of the original, e.g. huge pages for a large body.
+		Buffer buffer = IsUnique() ? std::move(_Block->Content) : _Block->Content.Clone(_Block->Content.Resource());
+		Release();
+		return buffer;
+	}
+
+	// Private
+
+	void SharedBuffer::Release()
+	{
+		// The last owner has to see every write made through the others before freeing.
+		if (_Block != nullptr && _Block->RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			delete _Block;
+		_Block = nullptr;
+	}
+}
@@ -0,0 +1,66 @@
+// File: SharedBuffer.hpp
+// Author: Rendong Liang (Liong)
+
+#pragma once
+#include "Fundamental.hpp"
+#include "Buffer.hpp"
+
+namespace LiongPlus
+{
+	/*
+	 * An immutable, reference-counted Buffer. Copies share the bytes, so a response built once can be handed to any number of connections and threads without copying it per send.
+	 * Mutation goes through MutableField(), which detaches a private copy first if the bytes are shared.
+	 */
+	class SharedBuffer
+	{
+		friend void swap(SharedBuffer& x, SharedBuffer& y)
+		{
+			std::swap(x._Block, y._Block);
+		}
+	private:
+		struct Block
+		{
+			std::atomic<size_t> RefCount;
+			Buffer Content;
+		};
+
+		Block* _Block;
+
+		void Release();
+	public:
+		SharedBuffer();
+		SharedBuffer(const SharedBuffer&);
+		SharedBuffer(SharedBuffer&&);
+		/*
+		 * Take over $buffer without copying it.
+		 */
+		SharedBuffer(Buffer&& buffer);
+		~SharedBuffer();
+
+		SharedBuffer& operator=(const SharedBuffer&);
+		SharedBuffer& operator=(SharedBuffer&&);
+		Byte operator[](size_t index) const;
+
+		const Byte* Field() const;
+		size_t Length() const;
+		bool IsEmpty() const;
+		/*
+		 * [return] True if no other SharedBuffer refers to the bytes. Only meaningful while no other thread copies this instance.
+		 */
+		bool IsUnique() const;
+
+		/*
+		 * [return] A private, mutable copy of the bytes.
+		 */
+		Buffer Clone(Memory::MemoryResource* resource = Memory::MemoryResource::Default()) const;
+
+		/*
+		 * Copy the bytes first if they are shared, so that writes are not seen through other instances. The copy comes from the same resource as the original.
+		 */
+		Byte* MutableField();
+		/*
+		 * [return] The bytes as a Buffer, moved out if this instance is the only owner, copied from the same resource otherwise. This instance is left empty.
+		 */
+		Buffer Detach();
+	};
+}
@@ -8,15 +8,18 @@ namespace LiongPlus
 	{
 		void Assert::Discriminate(bool isTrue)
 		{
+			auto& result = UnitTest::Current();
 			if (isTrue)
 			{
-				UnitTest::Results.Last().State = TestState::Passed;
-				*UnitTest::Results.Last().Log << "[Passed]";
+				// A passed assertion must not hide an earlier failed one.
+				if (result.State != TestState::Failed)
+					result.State = TestState::Passed;
+				*result.Log << "[Passed]";
 			}
 			else
 			{
-				UnitTest::Results.Last().State = TestState::Failed;
-				*UnitTest::Results.Last().Log << "[Assertion failed]";
+				result.State = TestState::Failed;
+				*result.Log << "[Assertion failed]";
 			}
 		}
 	}
@@ -18,8 +18,8 @@ namespace LiongPlus
 			{
 				if (actual != expectance)
 				{
-					UnitTest::_Results.Last().State = TestState::Skipped;
-					UnitTest::_Results.Last().Log.AppendLine(std::string("[Invalid Input(s), skip]"));
+					UnitTest::Current().State = TestState::Skipped;
+					*UnitTest::Current().Log << "[Invalid Input(s), skip]";
 				}
 			}
 
@@ -32,8 +32,8 @@ namespace LiongPlus
 				}
 				catch (...)
 				{
-					UnitTest::_Results.Last().State = TestState::Skipped;
-					UnitTest::_Results.Last().Log.AppendLine(std::string("[Invalid Input(s), skip]"));
+					UnitTest::Current().State = TestState::Skipped;
+					*UnitTest::Current().Log << "[Invalid Input(s), skip]";
 				}
 			}
 		};
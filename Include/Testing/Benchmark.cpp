@@ -0,0 +1,341 @@
+// File: Benchmark.cpp
+// Author: Rendong Liang (Liong)
+#include "Benchmark.hpp"
+#include "UnitTest.hpp"
+
+namespace LiongPlus
+{
+	namespace Testing
+	{
+		using namespace std::chrono;
+
+#ifdef _L_MSVC
+		void UseCharPointer(const volatile char* ptr)
+		{
+		}
+#endif
+
+		BenchmarkState::BenchmarkState(size_t iterations)
+			: _Iterations(iterations)
+			, _BytesPerIteration(0)
+			, _Paused()
+			, _PauseStart()
+		{
+		}
+
+		size_t BenchmarkState::Iterations() const
+		{
+			return _Iterations;
+		}
+
+		void BenchmarkState::SetBytesProcessed(size_t bytesPerIteration)
+		{
+			_BytesPerIteration = bytesPerIteration;
+		}
+		size_t BenchmarkState::BytesProcessed() const
+		{
+			return _BytesPerIteration;
+		}
+
+		void BenchmarkState::PauseTiming()
+		{
+			_PauseStart = steady_clock::now();
+		}
+		void BenchmarkState::ResumeTiming()
+		{
+			_Paused += steady_clock::now() - _PauseStart;
+		}
+		steady_clock::duration BenchmarkState::Paused() const
+		{
+			return _Paused;
+		}
+
+
+
+		std::vector<Benchmark::Registration> Benchmark::_Registrations;
+
+		Benchmark::Options::Options()
+			: Filter("*")
+			, MinTime(milliseconds(100))
+			, Repetitions(10)
+			, JsonPath()
+			, UseCounters(false)
+			, TrackAllocations(false)
+		{
+		}
+
+		void Benchmark::Register(std::string name, TFunction function)
+		{
+			Registration registration;
+			registration.Name = std::move(name);
+			registration.Function = std::move(function);
+			_Registrations.push_back(std::move(registration));
+		}
+
+		BenchmarkResult Benchmark::Measure(const std::string& name, const TFunction& function, const Options& options)
+		{
+			auto iterations = Calibrate(function, options.MinTime);
+			size_t bytesPerIteration;
+			// Warm caches, branch predictors and CPU frequency up before anything is recorded.
+			Measure(function, iterations, bytesPerIteration, nullptr, nullptr);
+
+			std::unique_ptr<PerfCounters> counters(options.UseCounters ? new PerfCounters() : nullptr);
+			PerfCounters::Sample total = {};
+			for (auto& isAvailable : total.IsAvailable)
+				isAvailable = counters != nullptr;
+
+			std::vector<double> samples;
+			for (size_t i = 0; i < std::max(options.Repetitions, (size_t)1); ++i)
+			{
+				PerfCounters::Sample sample;
+				auto elapsed = Measure(function, iterations, bytesPerIteration, counters.get(), &sample);
+				samples.push_back(duration<double, std::nano>(elapsed).count() / iterations);
+				if (counters == nullptr)
+					continue;
+				for (int j = 0; j < PerfCounters::COUNTER_COUNT; ++j)
+				{
+					total.Values[j] += sample.Values[j];
+					total.IsAvailable[j] = total.IsAvailable[j] && sample.IsAvailable[j];
+				}
+			}
+			std::sort(samples.begin(), samples.end());
+
+			BenchmarkResult result;
+			for (int i = 0; i < PerfCounters::COUNTER_COUNT; ++i)
+			{
+				result.HasCounter[i] = total.IsAvailable[i];
+				result.Counters[i] = total.IsAvailable[i] ? total.Values[i] / ((double)iterations * samples.size()) : 0;
+			}
+			result.Name = name;
+			result.Iterations = iterations;
+			result.Repetitions = samples.size();
+			result.MinNs = samples.front();
+			result.MeanNs = 0;
+			for (auto sample : samples)
+				result.MeanNs += sample;
+			result.MeanNs /= samples.size();
+			result.MedianNs = samples.size() % 2 == 0 ?
+				(samples[samples.size() / 2 - 1] + samples[samples.size() / 2]) / 2 :
+				samples[samples.size() / 2];
+			result.P99Ns = samples[(size_t)std::ceil(samples.size() * 0.99) - 1];
+			result.BytesPerSecond = bytesPerIteration * 1e9 / result.MedianNs;
+
+			result.HasAllocations = options.TrackAllocations;
+			result.AllocationsPerOp = 0;
+			result.AllocatedBytesPerOp = 0;
+			if (options.TrackAllocations)
+			{
+				// Tracking takes a lock per allocation, so it is kept out of the timed runs.
+				Memory::AllocationTracker tracker;
+				auto previous = Memory::SetAllocationHook(&tracker);
+				Measure(function, iterations, bytesPerIteration, nullptr, nullptr);
+				Memory::SetAllocationHook(previous);
+				auto report = tracker.Snapshot();
+				result.AllocationsPerOp = (double)report.Total.Allocations / iterations;
+				result.AllocatedBytesPerOp = (double)report.Total.AllocatedBytes / iterations;
+				result.AllocationSites = std::move(report.Sites);
+			}
+			return result;
+		}
+
+		std::vector<BenchmarkResult> Benchmark::Run(const Options& options, const Action<const BenchmarkResult&>& onResult)
+		{
+			std::vector<BenchmarkResult> results;
+			for (auto& registration : _Registrations)
+			{
+				if (!UnitTest::IsMatch(options.Filter.c_str(), registration.Name.c_str()))
+					continue;
+				results.push_back(Measure(registration.Name, registration.Function, options));
+				if (onResult)
+					onResult(results.back());
+			}
+			return results;
+		}
+
+		int Benchmark::Run(int argc, char** argv)
+		{
+			Options options;
+			for (int i = 1; i < argc; ++i)
+			{
+				std::string arg = argv[i];
+				if (arg.compare(0, 9, "--filter=") == 0)
+					options.Filter = arg.substr(9);
+				else if (arg.compare(0, 11, "--min-time=") == 0)
+					options.MinTime = milliseconds(std::atol(arg.c_str() + 11));
+				else if (arg.compare(0, 14, "--repetitions=") == 0)
+					options.Repetitions = std::atol(arg.c_str() + 14);
+				else if (arg.compare(0, 7, "--json=") == 0)
+					options.JsonPath = arg.substr(7);
+				else if (arg == "--counters")
+					options.UseCounters = true;
+				else if (arg == "--allocations")
+					options.TrackAllocations = true;
+				else
+					throw std::runtime_error("Unknown option: " + arg);
+			}
+
+			auto& out = options.JsonPath == "-" ? std::cerr : std::cout;
+			if (options.UseCounters && !PerfCounters().IsAnyAvailable())
+			{
+				out << "Hardware counters are unavailable, only time is measured." << std::endl;
+				options.UseCounters = false;
+			}
+			out << std::left << std::setw(40) << "Benchmark" << std::right
+				<< std::setw(14) << "Median ns" << std::setw(14) << "P99 ns" << std::setw(14) << "Min ns"
+				<< std::setw(14) << "MB/s" << std::setw(14) << "Iterations";
+			if (options.UseCounters)
+				out << std::setw(14) << "Cycles" << std::setw(14) << "IPC" << std::setw(14) << "Cache miss" << std::setw(14) << "Branch miss";
+			if (options.TrackAllocations)
+				out << std::setw(14) << "Allocs" << std::setw(14) << "Alloc bytes";
+			out << std::endl;
+			// Results are printed one by one, so that a long run shows progress.
+			auto results = Run(options, [&](const BenchmarkResult& result)
+			{
+				out << std::left << std::setw(40) << result.Name << std::right << std::fixed << std::setprecision(2)
+					<< std::setw(14) << result.MedianNs << std::setw(14) << result.P99Ns << std::setw(14) << result.MinNs
+					<< std::setw(14) << result.BytesPerSecond / 1e6 << std::setw(14) << result.Iterations;
+				if (options.UseCounters)
+				{
+					// Dashes for counters this machine does not have.
+					auto print = [&](bool isAvailable, double value)
+					{
+						if (isAvailable)
+							out << std::setw(14) << value;
+						else
+							out << std::setw(14) << "-";
+					};
+					print(result.HasCounter[PerfCounters::Cycles], result.Counters[PerfCounters::Cycles]);
+					print(result.HasCounter[PerfCounters::Cycles] && result.HasCounter[PerfCounters::Instructions],
+						result.Counters[PerfCounters::Instructions] / result.Counters[PerfCounters::Cycles]);
+					print(result.HasCounter[PerfCounters::CacheMisses], result.Counters[PerfCounters::CacheMisses]);
+					print(result.HasCounter[PerfCounters::BranchMisses], result.Counters[PerfCounters::BranchMisses]);
+				}
+				if (options.TrackAllocations)
+					out << std::setw(14) << result.AllocationsPerOp << std::setw(14) << result.AllocatedBytesPerOp;
+				out << std::endl;
+			});
+
+			if (options.JsonPath == "-")
+				std::cout << ToJson(results);
+			else if (!options.JsonPath.empty())
+			{
+				std::ofstream file(options.JsonPath);
+				if (!file)
+					throw std::runtime_error("Failed in opening $path for JSON output.");
+				file << ToJson(results);
+			}
+			return 0;
+		}
+
+		std::string Benchmark::ToJson(const std::vector<BenchmarkResult>& results)
+		{
+			std::stringstream json;
+			json << std::setprecision(17);
+			json << "{\n  \"time\": " << time(nullptr) << ",\n  \"benchmarks\": [";
+			for (size_t i = 0; i < results.size(); ++i)
+			{
+				auto& result = results[i];
+				json << (i == 0 ? "\n" : ",\n")
+					<< "    {\n"
+					<< "      \"name\": " << JsonString(result.Name.c_str()) << ",\n"
+					<< "      \"iterations\": " << result.Iterations << ",\n"
+					<< "      \"repetitions\": " << result.Repetitions << ",\n"
+					<< "      \"ns_per_op\": { \"min\": " << result.MinNs << ", \"mean\": " << result.MeanNs
+					<< ", \"median\": " << result.MedianNs << ", \"p99\": " << result.P99Ns << " },\n"
+					<< "      \"bytes_per_second\": " << result.BytesPerSecond << ",\n"
+					<< "      \"counters_per_op\": {";
+				for (int j = 0; j < PerfCounters::COUNTER_COUNT; ++j)
+				{
+					json << (j == 0 ? " \"" : ", \"") << PerfCounters::Name((PerfCounters::Counter)j) << "\": ";
+					if (result.HasCounter[j])
+						json << result.Counters[j];
+					else
+						json << "null";
+				}
+				json << " },\n"
+					<< "      \"allocations_per_op\": ";
+				if (result.HasAllocations)
+				{
+					json << "{ \"count\": " << result.AllocationsPerOp << ", \"bytes\": " << result.AllocatedBytesPerOp << ", \"sites\": [";
+					for (size_t j = 0; j < result.AllocationSites.size(); ++j)
+					{
+						auto& site = result.AllocationSites[j];
+						json << (j == 0 ? "\n" : ",\n")
+							<< "        { \"name\": " << JsonString(site.Site->Name)
+							<< ", \"file\": " << JsonString(site.Site->File)
+							<< ", \"line\": " << site.Site->Line
+							<< ", \"scope\": " << (site.Scope != nullptr ? JsonString(site.Scope) : "null")
+							<< ", \"count\": " << (double)site.Allocations / result.Iterations
+							<< ", \"bytes\": " << (double)site.AllocatedBytes / result.Iterations << " }";
+					}
+					json << (result.AllocationSites.empty() ? "] }" : "\n      ] }");
+				}
+				else
+					json << "null";
+				json << "\n"
+					<< "    }";
+			}
+			json << "\n  ]\n}\n";
+			return json.str();
+		}
+
+		// Private
+
+		std::string Benchmark::JsonString(const char* str)
+		{
+			std::string json = "\"";
+			for (; *str != '\0'; ++str)
+			{
+				if (*str == '"' || *str == '\\')
+					json += '\\';
+				// Control characters are not allowed raw in JSON strings.
+				if ((unsigned char)*str < 0x20)
+				{
+					char escaped[8];
+					snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char)*str);
+					json += escaped;
+				}
+				else
+					json += *str;
+			}
+			return json + '"';
+		}
+
+		steady_clock::duration Benchmark::Measure(const TFunction& function, size_t iterations, size_t& bytesPerIteration, PerfCounters* counters, PerfCounters::Sample* sample)
+		{
+			BenchmarkState state(iterations);
+			ClobberMemory();
+			if (counters != nullptr)
+				counters->Start();
+			auto start = steady_clock::now();
+			function(state);
+			auto elapsed = steady_clock::now() - start;
+			if (counters != nullptr)
+				*sample = counters->Stop();
+			ClobberMemory();
+			bytesPerIteration = state.BytesProcessed();
+			return elapsed - state.Paused();
+		}
+
+		size_t Benchmark::Calibrate(const TFunction& function, steady_clock::duration minTime)
+		{
+			size_t iterations = 1, bytesPerIteration;
+			while (true)
+			{
+				auto elapsed = Measure(function, iterations, bytesPerIteration, nullptr, nullptr);
+				if (elapsed >= minTime)
+					return iterations;
+				// Aim a bit past the target, but grow at most tenfold so that a noisy first run cannot overshoot wildly.
+				double scale = elapsed.count() > 0 ? 1.4 * minTime.count() / elapsed.count() : 10;
+				iterations = (size_t)(iterations * std::min(std::max(scale, 2.0), 10.0));
+			}
+		}
+
+
+
+		BenchmarkRegistrar::BenchmarkRegistrar(std::string name, Benchmark::TFunction function)
+		{
+			Benchmark::Register(std::move(name), std::move(function));
+		}
+	}
+}
@@ -0,0 +1,171 @@
+// File: Benchmark.hpp
+// Author: Rendong Liang (Liong)
+
+#ifndef _L_Benchmark
+#define _L_Benchmark
+#include "../Fundamental.hpp"
+#include "../Memory/Allocation.hpp"
+#include "PerfCounters.hpp"
+
+namespace LiongPlus
+{
+	namespace Testing
+	{
+#ifdef _L_MSVC
+		void UseCharPointer(const volatile char* ptr);
+
+		/*
+		 * Force $value to be computed, even if the result is never used.
+		 */
+		template<typename T>
+		inline void DoNotOptimize(const T& value)
+		{
+			UseCharPointer(&reinterpret_cast<const volatile char&>(value));
+			_ReadWriteBarrier();
+		}
+		/*
+		 * Force all pending writes to memory to be done here.
+		 */
+		inline void ClobberMemory()
+		{
+			_ReadWriteBarrier();
+		}
+#else
+		/*
+		 * Force $value to be computed, even if the result is never used.
+		 */
+		template<typename T>
+		inline void DoNotOptimize(const T& value)
+		{
+			__asm__ __volatile__("" : : "r,m"(value) : "memory");
+		}
+		/*
+		 * Force all pending writes to memory to be done here.
+		 */
+		inline void ClobberMemory()
+		{
+			__asm__ __volatile__("" : : : "memory");
+		}
+#endif
+
+		/*
+		 * Passed to a benchmark, which should run its operation Iterations() times.
+		 */
+		class BenchmarkState
+		{
+		private:
+			size_t _Iterations;
+			size_t _BytesPerIteration;
+			std::chrono::steady_clock::duration _Paused;
+			std::chrono::steady_clock::time_point _PauseStart;
+		public:
+			BenchmarkState(size_t iterations);
+
+			size_t Iterations() const;
+			/*
+			 * Declare how many bytes one iteration processes, so that throughput is reported.
+			 */
+			void SetBytesProcessed(size_t bytesPerIteration);
+			size_t BytesProcessed() const;
+
+			/*
+			 * Exclude the time until ResumeTiming() is called, e.g. to set up inputs.
+			 */
+			void PauseTiming();
+			void ResumeTiming();
+			std::chrono::steady_clock::duration Paused() const;
+		};
+
+		struct BenchmarkResult
+		{
+			std::string Name;
+			size_t Iterations;
+			size_t Repetitions;
+			// Nanoseconds per iteration across repetitions.
+			double MinNs, MeanNs, MedianNs, P99Ns;
+			// Zero if the benchmark did not declare bytes processed.
+			double BytesPerSecond;
+			// Hardware counts per iteration, averaged over repetitions. Only meaningful where $HasCounter is true.
+			double Counters[PerfCounters::COUNTER_COUNT];
+			bool HasCounter[PerfCounters::COUNTER_COUNT];
+			// Allocations made through any Memory::MemoryResource per iteration, measured in a separate untimed run. Only meaningful if $HasAllocations is true.
+			bool HasAllocations;
+			double AllocationsPerOp, AllocatedBytesPerOp;
+			// Totals of the allocation run, divide by $Iterations for per-iteration figures.
+			std::vector<Memory::AllocationTracker::SiteStats> AllocationSites;
+		};
+
+		/*
+		 * Registered benchmarks are calibrated, warmed up and repeated by Run(), which reports time per iteration and throughput.
+		 */
+		class Benchmark
+		{
+		public:
+			typedef Action<BenchmarkState&> TFunction;
+
+			struct Options
+			{
+				std::string Filter;
+				std::chrono::steady_clock::duration MinTime;
+				size_t Repetitions;
+				// Empty to skip JSON output, "-" for standard output.
+				std::string JsonPath;
+				// Sample hardware counters as well, where available.
+				bool UseCounters;
+				// Count allocations in an extra run.
+				bool TrackAllocations;
+
+				Options();
+			};
+		private:
+			struct Registration
+			{
+				std::string Name;
+				TFunction Function;
+			};
+
+			static std::vector<Registration> _Registrations;
+
+			static std::chrono::steady_clock::duration Measure(const TFunction& function, size_t iterations, size_t& bytesPerIteration, PerfCounters* counters, PerfCounters::Sample* sample);
+			static size_t Calibrate(const TFunction& function, std::chrono::steady_clock::duration minTime);
+			static std::string JsonString(const char* str);
+		public:
+			static void Register(std::string name, TFunction function);
+
+			/*
+			 * Run a single benchmark.
+			 */
+			static BenchmarkResult Measure(const std::string& name, const TFunction& function, const Options& options);
+			/*
+			 * Run registered benchmarks.
+			 * [param] onResult Called with each result as soon as it is measured, e.g. to show progress. May be empty.
+			 */
+			static std::vector<BenchmarkResult> Run(const Options& options, const Action<const BenchmarkResult&>& onResult = nullptr);
+			/*
+			 * Run registered benchmarks with options from command line and print results.
+			 * Options:
+			 *   --filter=<pattern>     Run only benchmarks matching the pattern, where '*' matches any string and '?' any character.
+			 *   --min-time=<ms>        Minimal time of each repetition, 100 by default.
+			 *   --repetitions=<n>      Number of measured repetitions, 10 by default.
+			 *   --json=<path>          Also write results as JSON to the file, or standard output if it is '-'.
+			 *   --counters             Also report cycles, instructions, cache misses and branch misses per iteration, where the system allows.
+			 *   --allocations          Also report allocations and bytes allocated per iteration, in total and by call site.
+			 */
+			static int Run(int argc, char** argv);
+
+			static std::string ToJson(const std::vector<BenchmarkResult>& results);
+		};
+
+		class BenchmarkRegistrar
+		{
+		public:
+			BenchmarkRegistrar(std::string name, Benchmark::TFunction function);
+		};
+	}
+}
+
+#define _L_Benchmark_Case(name) \
+	static void name(LiongPlus::Testing::BenchmarkState& state); \
+	static LiongPlus::Testing::BenchmarkRegistrar _L_Benchmark_Registrar_##name(#name, name); \
+	static void name(LiongPlus::Testing::BenchmarkState& state)
+#endif
@@ -8,7 +8,7 @@ namespace LiongPlus
 	{
 		void Logger::Log(std::string label, std::string msg)
 		{
-			*UnitTest::Results.Last().Log << DateTime::GetCustomized("%H:%M:%S", time(nullptr)) << label << msg;
+			*UnitTest::Current().Log << DateTime::GetCustomized("%H:%M:%S", time(nullptr)) << label << msg;
 		}
 
 		void Logger::Info(std::string msg)
@@ -0,0 +1,111 @@
+// File: PerfCounters.cpp
+// Author: Rendong Liang (Liong)
+#include "PerfCounters.hpp"
+
+#ifdef _L_LINUX
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+namespace LiongPlus
+{
+	namespace Testing
+	{
+		PerfCounters::PerfCounters()
+			: _Handles()
+			, _Starts()
+		{
+			for (auto& handle : _Handles)
+				handle = -1;
+#ifdef _L_LINUX
+			static const uint64_t CONFIGS[COUNTER_COUNT] =
+			{
+				PERF_COUNT_HW_CPU_CYCLES,
+				PERF_COUNT_HW_INSTRUCTIONS,
+				PERF_COUNT_HW_CACHE_MISSES,
+				PERF_COUNT_HW_BRANCH_MISSES
+			};
+			for (int i = 0; i < COUNTER_COUNT; ++i)
+			{
+				perf_event_attr attr = {};
+				attr.size = sizeof(attr);
+				attr.type = PERF_TYPE_HARDWARE;
+				attr.config = CONFIGS[i];
+				attr.disabled = 1;
+				// User space only, which is all that unprivileged processes may count anyway.
+				attr.exclude_kernel = 1;
+				attr.exclude_hv = 1;
+				attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+				// Counters are opened separately rather than as a group, so that one the hardware lacks does not take the others down.
+				_Handles[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+				if (_Handles[i] >= 0)
+					ioctl(_Handles[i], PERF_EVENT_IOC_ENABLE, 0);
+			}
+#endif
+		}
+		PerfCounters::~PerfCounters()
+		{
+#ifdef _L_LINUX
+			for (auto handle : _Handles)
+			{
+				if (handle >= 0)
+					close(handle);
+			}
+#endif
+		}
+
+		bool PerfCounters::IsAvailable(Counter counter) const
+		{
+			return _Handles[counter] >= 0;
+		}
+		bool PerfCounters::IsAnyAvailable() const
+		{
+			for (int i = 0; i < COUNTER_COUNT; ++i)
+			{
+				if (IsAvailable((Counter)i))
+					return true;
+			}
+			return false;
+		}
+
+		void PerfCounters::Start()
+		{
+			for (int i = 0; i < COUNTER_COUNT; ++i)
+				Read((Counter)i, _Starts[i]);
+		}
+
+		PerfCounters::Sample PerfCounters::Stop()
+		{
+			Sample sample;
+			for (int i = 0; i < COUNTER_COUNT; ++i)
+			{
+				uint64_t values[3];
+				Read((Counter)i, values);
+				auto value = values[0] - _Starts[i][0];
+				auto enabled = values[1] - _Starts[i][1];
+				auto running = values[2] - _Starts[i][2];
+				sample.IsAvailable[i] = IsAvailable((Counter)i) && running > 0;
+				sample.Values[i] = sample.IsAvailable[i] ? (double)value * enabled / running : 0;
+			}
+			return sample;
+		}
+
+		const char* PerfCounters::Name(Counter counter)
+		{
+			static const char* const NAMES[COUNTER_COUNT] = { "cycles", "instructions", "cache_misses", "branch_misses" };
+			return NAMES[counter];
+		}
+
+		// Private
+
+		void PerfCounters::Read(Counter counter, uint64_t (&values)[3]) const
+		{
+			values[0] = values[1] = values[2] = 0;
+#ifdef _L_LINUX
+			if (_Handles[counter] >= 0 && read(_Handles[counter], values, sizeof(values)) != sizeof(values))
+				values[0] = values[1] = values[2] = 0;
+#endif
+		}
+	}
+}
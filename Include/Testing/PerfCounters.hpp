@@ -0,0 +1,58 @@
+// File: PerfCounters.hpp
+// Author: Rendong Liang (Liong)
+
+#ifndef _L_PerfCounters
+#define _L_PerfCounters
+#include "../Fundamental.hpp"
+
+namespace LiongPlus
+{
+	namespace Testing
+	{
+		/*
+		 * Hardware performance counters of the calling thread, based on perf_event_open(2).
+		 * Counters the kernel refuses to open (e.g. in containers, virtual machines, or with a strict perf_event_paranoid) are reported unavailable rather than failing. On other platforms none are available.
+		 */
+		class PerfCounters
+		{
+		public:
+			enum Counter
+			{
+				Cycles,
+				Instructions,
+				CacheMisses,
+				BranchMisses,
+				COUNTER_COUNT
+			};
+
+			struct Sample
+			{
+				// Counts scaled up for the time the kernel had the counter multiplexed out.
+				double Values[COUNTER_COUNT];
+				bool IsAvailable[COUNTER_COUNT];
+			};
+		private:
+			int _Handles[COUNTER_COUNT];
+			uint64_t _Starts[COUNTER_COUNT][3];
+
+			void Read(Counter counter, uint64_t (&values)[3]) const;
+		public:
+			PerfCounters();
+			PerfCounters(const PerfCounters&) = delete;
+			PerfCounters(PerfCounters&&) = delete;
+			~PerfCounters();
+
+			bool IsAvailable(Counter counter) const;
+			bool IsAnyAvailable() const;
+
+			void Start();
+			/*
+			 * [return] Counts since the last Start().
+			 */
+			Sample Stop();
+
+			static const char* Name(Counter counter);
+		};
+	}
+}
+#endif
@@ -9,7 +9,9 @@ namespace LiongPlus
 		using std::swap;
 
 		std::mutex UnitTest::_Mutex;
-		std::vector<TestResult> UnitTest::_Results;
+		std::deque<TestResult> UnitTest::_Results;
+		std::vector<UnitTest::Registration> UnitTest::_Registrations;
+		thread_local UnitTest::Context* UnitTest::_Context = nullptr;
 		UnitTest::ResultsObject UnitTest::Results;
 
 		TestObject::TestObject()
@@ -29,21 +31,24 @@ namespace LiongPlus
 
 
 		TestResult::TestResult()
-			: Log()
+			: Log(std::make_shared<std::stringstream>())
 			, Name(std::string())
 			, State(TestState::Waiting)
+			, Duration()
 		{
 		}
 		TestResult::TestResult(std::string name)
-			: Log()
+			: Log(std::make_shared<std::stringstream>())
 			, Name(name)
 			, State(TestState::Waiting)
+			, Duration()
 		{
 		}
 		TestResult::TestResult(const TestResult& instance)
 			: Log(instance.Log)
 			, Name(instance.Name)
 			, State(instance.State)
+			, Duration(instance.Duration)
 		{
 		}
 		TestResult::TestResult(TestResult&& instance)
@@ -52,6 +57,7 @@ namespace LiongPlus
 			swap(Log, instance.Log);
 			swap(Name,  instance.Name);
 			swap(State, instance.State);
+			swap(Duration, instance.Duration);
 		}
 
 		TestResult& TestResult::operator=(const TestResult& instance)
@@ -59,6 +65,7 @@ namespace LiongPlus
 			Log = instance.Log;
 			Name = instance.Name;
 			State = instance.State;
+			Duration = instance.Duration;
 			return *this;
 		}
 		TestResult& TestResult::operator=(TestResult&& instance)
@@ -66,6 +73,7 @@ namespace LiongPlus
 			swap(Log, instance.Log);
 			swap(Name, instance.Name);
 			swap(State, instance.State);
+			swap(Duration, instance.Duration);
 			return *this;
 		}
 
@@ -83,26 +91,144 @@ namespace LiongPlus
 			obj.CleanUp();
 		}
 
-		void UnitTest::RunUnit(std::function<void(void)> unit)
+		void UnitTest::RunUnit(std::string name, std::function<void(void)> unit)
 		{
-			UnitTest::_Mutex.lock();
+			auto context = _Context;
+			if (context != nullptr && !IsMatch(context->UnitFilter.c_str(), name.c_str()))
+				return;
+
+			TestResult result(context != nullptr ? context->Prefix + name : name);
+			// Not run by Run(), so there is no slot of our own. The result is shared once the unit is done.
+			Context standalone;
+			bool isStandalone = context == nullptr;
+			if (isStandalone)
+			{
+				standalone.Slot = nullptr;
+				context = _Context = &standalone;
+			}
+			context->Current = &result;
+
+			auto start = std::chrono::steady_clock::now();
 			try
 			{
 				unit();
 			}
+			catch (const std::exception& e)
+			{
+				*result.Log << "[Exception occured: " << e.what() << "]";
+				result.State = TestState::Failed;
+			}
 			catch (...)
 			{
-				*_Results.back().Log << "[Exception occured, please debug this test]";
-				_Results.back().State = TestState::Failed;
-				return;
+				*result.Log << "[Exception occured, please debug this test]";
+				result.State = TestState::Failed;
+			}
+			result.Duration = std::chrono::steady_clock::now() - start;
+			if (result.State == TestState::Waiting)
+				result.State = TestState::Passed;
+
+			context->Current = nullptr;
+			if (isStandalone)
+			{
+				_Context = nullptr;
+				std::lock_guard<std::mutex> lock(_Mutex);
+				_Results.push_back(std::move(result));
+			}
+			else
+				context->Slot->push_back(std::move(result));
+		}
+
+		TestResult& UnitTest::Current()
+		{
+			auto context = _Context;
+			if (context != nullptr && context->Current != nullptr)
+				return *context->Current;
+
+			std::lock_guard<std::mutex> lock(_Mutex);
+			if (_Results.empty())
+				throw std::logic_error("No test is running.");
+			return _Results.back();
+		}
+
+		void UnitTest::Register(std::string name, TFactory factory)
+		{
+			std::lock_guard<std::mutex> lock(_Mutex);
+			Registration registration;
+			registration.Name = std::move(name);
+			registration.Factory = std::move(factory);
+			_Registrations.push_back(std::move(registration));
+		}
+
+		int UnitTest::Run(int argc, char** argv)
+		{
+			std::string objectFilter = "*", unitFilter = "*";
+			size_t jobCount = std::max(std::thread::hardware_concurrency(), 1u);
+			for (int i = 1; i < argc; ++i)
+			{
+				std::string arg = argv[i];
+				if (arg.compare(0, 9, "--filter=") == 0)
+				{
+					auto filter = arg.substr(9);
+					auto dot = filter.find('.');
+					objectFilter = filter.substr(0, dot);
+					unitFilter = dot == std::string::npos ? "*" : filter.substr(dot + 1);
+				}
+				else if (arg.compare(0, 7, "--jobs=") == 0)
+					jobCount = std::max(std::atoi(arg.c_str() + 7), 1);
+				else
+					throw std::runtime_error("Unknown option: " + arg);
+			}
+
+			std::vector<const Registration*> selected;
+			for (auto& registration : _Registrations)
+			{
+				if (IsMatch(objectFilter.c_str(), registration.Name.c_str()))
+					selected.push_back(&registration);
 			}
-			if (_Results.back().State == TestState::Waiting)
-				_Results.back().State = TestState::Passed;
-			UnitTest::_Mutex.unlock();
+
+			// Every test object writes to its own slot, so workers share nothing but the index of the next object.
+			std::vector<std::vector<TestResult>> slots(selected.size());
+			std::atomic<size_t> next(0);
+			auto work = [&]
+			{
+				for (size_t i = next++; i < selected.size(); i = next++)
+					RunObject(*selected[i], unitFilter, slots[i]);
+			};
+			auto start = std::chrono::steady_clock::now();
+			std::vector<std::thread> workers;
+			for (size_t i = 1; i < std::min(jobCount, selected.size()); ++i)
+				workers.emplace_back(work);
+			work();
+			for (auto& worker : workers)
+				worker.join();
+			auto elapsed = std::chrono::steady_clock::now() - start;
+
+			int failed = 0;
+			{
+				std::lock_guard<std::mutex> lock(_Mutex);
+				for (auto& slot : slots)
+				{
+					for (auto& result : slot)
+					{
+						static const char* const STATE_LABELS[] = { "[WAITING]", "[PASSED] ", "[FAILED] ", "[SKIPPED]" };
+						auto ms = std::chrono::duration<double, std::milli>(result.Duration).count();
+						std::cout << STATE_LABELS[(int)result.State] << ' ' << result.Name << " (" << ms << " ms)" << std::endl;
+						if (result.State == TestState::Failed)
+						{
+							std::cout << "  " << result.Log->str() << std::endl;
+							++failed;
+						}
+						_Results.push_back(std::move(result));
+					}
+				}
+			}
+			std::cout << Summary() << " Wall time: " << std::chrono::duration<double, std::milli>(elapsed).count() << " ms." << std::endl;
+			return failed;
 		}
 
 		std::string UnitTest::Summary()
 		{
+			std::lock_guard<std::mutex> lock(_Mutex);
 			long passed = 0;
 			for (auto& result : _Results)
 			{
@@ -113,15 +239,59 @@ namespace LiongPlus
 		}
 		std::vector<int> UnitTest::ListResultId(TestState state)
 		{
-			_Mutex.lock();
+			std::lock_guard<std::mutex> lock(_Mutex);
 			std::vector<int> list;
 			for (int i = 0; i < _Results.size(); ++i)
 			{
 				if (_Results[i].State == state)
 					list.push_back(i);
 			}
-			_Mutex.unlock();
 			return list;
 		}
+
+		bool UnitTest::IsMatch(const char* pattern, const char* str)
+		{
+			if (*pattern == '\0')
+				return *str == '\0';
+			if (*pattern == '*')
+				return IsMatch(pattern + 1, str) || (*str != '\0' && IsMatch(pattern, str + 1));
+			if (*str == '\0')
+				return false;
+			return (*pattern == '?' || *pattern == *str) && IsMatch(pattern + 1, str + 1);
+		}
+
+		// Private
+
+		void UnitTest::RunObject(const Registration& registration, const std::string& unitFilter, std::vector<TestResult>& slot)
+		{
+			Context context;
+			context.Prefix = registration.Name + ".";
+			context.UnitFilter = unitFilter;
+			context.Current = nullptr;
+			context.Slot = &slot;
+			_Context = &context;
+
+			try
+			{
+				auto obj = registration.Factory();
+				Test(*obj);
+			}
+			catch (...)
+			{
+				// Units catch their own exceptions, so this comes from construction, Prepare() or CleanUp().
+				TestResult result(context.Prefix + "<fixture>");
+				result.State = TestState::Failed;
+				*result.Log << "[Exception occured in test object]";
+				slot.push_back(std::move(result));
+			}
+			_Context = nullptr;
+		}
+
+
+
+		TestRegistrar::TestRegistrar(std::string name, UnitTest::TFactory factory)
+		{
+			UnitTest::Register(std::move(name), std::move(factory));
+		}
 	}
 }
\ No newline at end of file
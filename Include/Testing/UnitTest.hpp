@@ -42,6 +42,7 @@ namespace LiongPlus
 			std::shared_ptr<std::stringstream> Log;
 			std::string Name;
 			TestState State;
+			std::chrono::steady_clock::duration Duration;
 
 			TestResult();
 			TestResult(std::string name);
@@ -57,41 +58,99 @@ namespace LiongPlus
 		class UnitTest
 		{
 		public:
+			typedef Func<std::unique_ptr<TestObject>> TFactory;
+
 			static class ResultsObject
 			{
 			public:
 				TestResult& operator[](long index)
 				{
+					std::lock_guard<std::mutex> lock(_Mutex);
 					return _Results[index];
 				}
 
 				void Add(TestResult& result)
 				{
+					std::lock_guard<std::mutex> lock(_Mutex);
 					_Results.push_back(result);
 				}
 
+				/*
+				 * The result of the unit running on the calling thread, or the last one added if there is none.
+				 */
 				TestResult& Last()
 				{
-					return _Results.back();
+					return Current();
 				}
 			} Results;
 
 			static void Test(TestObject& obj);
 
-			static void RunUnit(std::function<void(void)> unit);
+			/*
+			 * Run $unit as a test named $name. Each unit owns its result, so units of different test objects can run on different threads.
+			 */
+			static void RunUnit(std::string name, std::function<void(void)> unit);
+			/*
+			 * The result of the unit running on the calling thread.
+			 */
+			static TestResult& Current();
+
+			/*
+			 * Register a test object to be created by $factory and run by Run().
+			 */
+			static void Register(std::string name, TFactory factory);
+			/*
+			 * Run registered test objects on a thread pool and print results with wall time.
+			 * Options:
+			 *   --filter=<object>[.<unit>]  Run only tests matching the pattern, where '*' matches any string and '?' any character.
+			 *   --jobs=<n>                  Number of threads, the number of cores by default.
+			 * [return] Number of failed units, usable as exit code.
+			 */
+			static int Run(int argc, char** argv);
 
 			static std::string Summary();
 			static std::vector<int> ListResultId(TestState state);
+
+			/*
+			 * Match $str against $pattern, where '*' matches any string and '?' any character.
+			 */
+			static bool IsMatch(const char* pattern, const char* str);
 		private:
+			struct Registration
+			{
+				std::string Name;
+				TFactory Factory;
+			};
+			struct Context
+			{
+				std::string Prefix;
+				std::string UnitFilter;
+				TestResult* Current;
+				std::vector<TestResult>* Slot;
+			};
+
 			static std::mutex _Mutex;
-			static std::vector<TestResult> _Results;
+			// A deque, so that references handed out stay valid while other threads add results.
+			static std::deque<TestResult> _Results;
+			static std::vector<Registration> _Registrations;
+			// Context of the unit or test object running on this thread, if any.
+			static thread_local Context* _Context;
+
+			static void RunObject(const Registration& registration, const std::string& unitFilter, std::vector<TestResult>& slot);
+		};
+
+		class TestRegistrar
+		{
+		public:
+			TestRegistrar(std::string name, UnitTest::TFactory factory);
 		};
 	}
 }
 
 #define _L_Test_Class(name) class name : public LiongPlus::Testing::TestObject
+#define _L_Test_Register(name) static LiongPlus::Testing::TestRegistrar _L_Test_Registrar_##name(#name, [] { return std::unique_ptr<LiongPlus::Testing::TestObject>(new name()); })
 #define _L_Test_Prepare virtual void Prepare() override final
 #define _L_Test_TestList virtual void Test() override final
 #define _L_Test_CleanUp virtual void CleanUp() override final
-#define _L_Test_Unit(name, func) LiongPlus::Testing::UnitTest::Results.Add(TestResult(name)); LiongPlus::Testing::UnitTest::RunUnit(func)
+#define _L_Test_Unit(name, func) LiongPlus::Testing::UnitTest::RunUnit(name, func)
 #endif
\ No newline at end of file
@@ -2,6 +2,7 @@
 // Author: Rendong Liang (Liong)
 
 #include "StringBuilder.hpp"
+#include "../Diagnostics/Trace.hpp"
 
 namespace LiongPlus
 {
@@ -14,16 +15,20 @@ namespace LiongPlus
 			, _Counter(new ReferenceCounter())
 			, _Capacity(_InitialCapacity)
 			, _Length(0)
-			, _Data(new _L_Char[_InitialCapacity] ,_InitialCapacity)
+			, _Data(_InitialCapacity)
 		{
 			_Counter->Inc();
 		}
 		StringBuilder::StringBuilder(long capacity)
+			: StringBuilder(capacity, Memory::MemoryResource::Default())
+		{
+		}
+		StringBuilder::StringBuilder(long capacity, Memory::MemoryResource* resource)
 			: _Next(nullptr)
 			, _Counter(new ReferenceCounter())
 			, _Capacity(capacity)
 			, _Length(0)
-			, _Data(new _L_Char[capacity], capacity)
+			, _Data(capacity, resource)
 		{
 			_Counter->Inc();
 		}
@@ -36,10 +41,10 @@ namespace LiongPlus
 			, _Counter(instance._Counter)
 			, _Capacity(instance._Capacity)
 			, _Length(instance._Length)
-			, _Data(new _L_Char[instance._Capacity], instance._Capacity)
+			, _Data(instance._Capacity)
 		{
 			_Counter->Inc();
-			Array<_L_Char>::Copy(_Data, instance._Data, _Length);
+			Array<_L_Char>::Copy(instance._Data, _Data, _Length);
 		}
 		StringBuilder::StringBuilder(StringBuilder&& instance)
 			: _Next(nullptr)
@@ -77,10 +82,10 @@ namespace LiongPlus
 			_Counter = instance._Counter;
 			_Capacity = instance._Capacity;
 			_Length = instance._Length;
-			_Data = Array<_L_Char>(new _L_Char[instance._Capacity], instance._Capacity);
+			_Data = Array<_L_Char>(instance._Capacity);
 			if (_Counter != nullptr)
 				_Counter->Inc();
-			Array<_L_Char>::Copy(_Data, instance._Data, _Length);
+			Array<_L_Char>::Copy(instance._Data, _Data, _Length);
 			return *this;
 		}
 		StringBuilder& StringBuilder::operator=(StringBuilder&& instance)
@@ -264,6 +269,7 @@ namespace LiongPlus
 		}
 		String StringBuilder::ToString()
 		{
+			_L_Trace_Span("text", "StringBuilder::ToString");
 			StringBuilder* ptr = this;
 			long length = 1; // Keep space for '\0'.
 			// Calculate the length of return string.
@@ -340,10 +346,8 @@ namespace LiongPlus
 					while (subobjectCounter-- > 0)
 					{
 						ptr->_Capacity = _MaxCapacity;
-						Array<_L_Char> expanded(_MaxCapacity);
-						Array<_L_Char>::Copy(ptr->_Data, expanded, ptr->_Capacity);
-						ptr->_Data = expanded;
-						ptr->_Next = new StringBuilder();
+						ptr->_Data.Resize(_MaxCapacity);
+						ptr->_Next = new StringBuilder(_InitialCapacity, ptr->_Data.Resource());
 						ptr = ptr->_Next;
 					}
 					ptr->Expand(_RemainderOf8192Devision & totalLength);
@@ -356,9 +360,7 @@ namespace LiongPlus
 					if (ptr->_Capacity > _MaxCapacity)
 						ptr->_Capacity = _MaxCapacity;
 
-					Array<_L_Char> expanded(_Capacity);
-					Array<_L_Char>::Copy(ptr->_Data, expanded, ptr->_Length);
-					ptr->_Data = expanded;
+					ptr->_Data.Resize(ptr->_Capacity);
 				}
 			}
 			ptr->_Length = totalLength;
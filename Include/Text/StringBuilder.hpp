@@ -19,6 +19,10 @@ namespace LiongPlus
 		public:
 			StringBuilder();
 			StringBuilder(long capacity);
+			/*
+			 * Allocate characters from $resource, which must outlive the builder and is shared by the nodes it grows into.
+			 */
+			StringBuilder(long capacity, Memory::MemoryResource* resource);
 			StringBuilder(String& str);
 			StringBuilder(const StringBuilder& instance);
 			StringBuilder(StringBuilder&& instance);
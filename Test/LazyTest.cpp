@@ -0,0 +1,55 @@
+// File: LazyTest.cpp
+// Author: Rendong Liang (Liong)
+#include "../Include/Lazy.hpp"
+#include "../Include/Testing/Assert.hpp"
+
+using namespace LiongPlus;
+using namespace LiongPlus::Testing;
+
+// Throws from its move constructor while $FailingMoveCount is positive.
+struct FragileValue
+{
+	static int FailingMoveCount;
+	int Value;
+
+	FragileValue(int value)
+		: Value(value)
+	{
+	}
+	FragileValue(FragileValue&& instance)
+		: Value(instance.Value)
+	{
+		if (FailingMoveCount > 0)
+		{
+			--FailingMoveCount;
+			throw std::runtime_error("Failed in moving.");
+		}
+	}
+};
+int FragileValue::FailingMoveCount = 0;
+
+_L_Test_Class(LazyTest)
+{
+	_L_Test_TestList
+	{
+		_L_Test_Unit("PublicationOnlyRetryAfterThrowingMove", []
+		{
+			Lazy<FragileValue> lazy([] { return FragileValue(42); }, LazyThreadSafetyMode::PublicationOnly);
+			FragileValue::FailingMoveCount = 1;
+			bool isThrown = false;
+			try
+			{
+				lazy.GetValue();
+			}
+			catch (const std::runtime_error&)
+			{
+				isThrown = true;
+			}
+			Assert::Equals(isThrown, true);
+			Assert::Equals(lazy.IsValueCreated(), false);
+			Assert::Equals(lazy.GetValue().Value, 42);
+			Assert::Equals(lazy.IsValueCreated(), true);
+		});
+	}
+};
+_L_Test_Register(LazyTest);
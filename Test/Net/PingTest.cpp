@@ -0,0 +1,61 @@
+// File: PingTest.cpp
+// Author: Rendong Liang (Liong)
+#include "../../Include/Net/Ping.hpp"
+#include "../../Include/Testing/Assert.hpp"
+#include "../../Include/Testing/Assume.hpp"
+
+#ifdef _L_LINUX
+using namespace LiongPlus::Net;
+using namespace LiongPlus::Testing;
+
+namespace
+{
+	// nullptr if this process may open neither kind of ICMP socket, in which case the unit is skipped.
+	std::unique_ptr<Ping> TryCreatePing()
+	{
+		try
+		{
+			return std::unique_ptr<Ping>(new Ping());
+		}
+		catch (const std::system_error& e)
+		{
+			auto error = e.code().value();
+			Assume::Equals(error != EPERM && error != EACCES, true);
+			if (UnitTest::Current().State != TestState::Skipped)
+				throw;
+			return nullptr;
+		}
+	}
+}
+
+_L_Test_Class(PingTest)
+{
+	_L_Test_TestList
+	{
+		_L_Test_Unit("SweepLoopback", []
+		{
+			auto ping = TryCreatePing();
+			if (ping == nullptr)
+				return;
+			auto stats = ping->Sweep({ IPv4EndPoint("127.0.0.1", 0) }, 3, 10, 1000);
+			Assert::Equals<size_t>(stats.size(), 1);
+			Assert::Equals(stats[0].Sent, 3L);
+			Assert::Equals(stats[0].Received, 3L);
+			Assert::Equals(stats[0].Lost, 0L);
+			Assert::Equals(stats[0].MinRtt <= stats[0].AverageRtt && stats[0].AverageRtt <= stats[0].P99Rtt, true);
+		});
+		_L_Test_Unit("IgnoreLateReplies", []
+		{
+			auto ping = TryCreatePing();
+			if (ping == nullptr)
+				return;
+			// Not waiting for replies leaves them queued for the next sweep, where they carry indices not sent yet.
+			ping->Sweep({ IPv4EndPoint("127.0.0.1", 0) }, 4, 0, 0);
+			auto stats = ping->Sweep({ IPv4EndPoint("127.0.0.1", 0) }, 4, 20, 1000);
+			Assert::Equals(stats[0].Received, 4L);
+			Assert::Equals(stats[0].Lost, 0L);
+		});
+	}
+};
+_L_Test_Register(PingTest);
+#endif // _L_LINUX
@@ -0,0 +1,128 @@
+// File: ResolverTest.cpp
+// Author: Rendong Liang (Liong)
+#include "../../Include/Net/Resolver.hpp"
+#include "../../Include/Testing/Assert.hpp"
+
+using namespace std::chrono;
+using namespace LiongPlus::Net;
+using namespace LiongPlus::Testing;
+
+namespace
+{
+	// Resolves "host" to one address of each family and fails on any other name, counting the lookups.
+	struct FakeLookup
+	{
+		std::atomic<int> Count;
+		std::mutex Mutex;
+		std::condition_variable Cond;
+		bool IsOpen;
+
+		FakeLookup()
+			: Count(0)
+			, Mutex()
+			, Cond()
+			, IsOpen(true)
+		{
+		}
+
+		Resolver::TLookup Function()
+		{
+			return [this](const std::string& name, int family)
+			{
+				++Count;
+				{
+					std::unique_lock<std::mutex> lock(Mutex);
+					Cond.wait(lock, [this] { return IsOpen; });
+				}
+				if (name != "host")
+					throw std::runtime_error("Failed in resolving host name.");
+				const uint8_t addr[16] = { 10, 0, 0, 1 };
+				return std::vector<SocketAddress>{ family == AF_INET ? SocketAddress(IPv4EndPoint(addr, 0)) : SocketAddress(IPv6EndPoint(addr, 0)) };
+			};
+		}
+		void Open()
+		{
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				IsOpen = true;
+			}
+			Cond.notify_all();
+		}
+	};
+}
+
+_L_Test_Class(ResolverTest)
+{
+	_L_Test_TestList
+	{
+		_L_Test_Unit("Cache", []
+		{
+			FakeLookup lookup;
+			Resolver resolver(2, seconds(60), seconds(60), lookup.Function());
+			auto addrs = resolver.Resolve("host");
+			Assert::Equals<size_t>(addrs.size(), 2);
+			Assert::Equals<int>(addrs[0].AddressFamily(), AF_INET);
+			Assert::Equals<int>(addrs[1].AddressFamily(), AF_INET6);
+			Assert::Equals(lookup.Count.load(), 2);
+
+			std::vector<SocketAddress> cached;
+			Assert::Equals(resolver.TryGetCached("host", cached), true);
+			Assert::Equals<size_t>(resolver.Resolve("host").size(), 2);
+			Assert::Equals(lookup.Count.load(), 2);
+		});
+		_L_Test_Unit("NegativeCache", []
+		{
+			FakeLookup lookup;
+			Resolver resolver(2, seconds(60), seconds(60), lookup.Function());
+			for (int i = 0; i < 2; ++i)
+			{
+				bool hasThrown = false;
+				try
+				{
+					resolver.Resolve("missing");
+				}
+				catch (const std::runtime_error&)
+				{
+					hasThrown = true;
+				}
+				Assert::Equals(hasThrown, true);
+			}
+			Assert::Equals(lookup.Count.load(), 2);
+		});
+		_L_Test_Unit("Expiry", []
+		{
+			FakeLookup lookup;
+			Resolver resolver(2, milliseconds(20), milliseconds(20), lookup.Function());
+			resolver.Resolve("host");
+			std::this_thread::sleep_for(milliseconds(40));
+			std::vector<SocketAddress> cached;
+			Assert::Equals(resolver.TryGetCached("host", cached), false);
+			resolver.Resolve("host");
+			Assert::Equals(lookup.Count.load(), 4);
+		});
+		_L_Test_Unit("ConcurrentLookUp", []
+		{
+			// Every request arrives while the first lookup is held back, so all of them share it.
+			FakeLookup lookup;
+			lookup.IsOpen = false;
+			Resolver resolver(2, seconds(60), seconds(60), lookup.Function());
+			std::atomic<int> resolved(0);
+			std::vector<std::thread> threads;
+			for (int i = 0; i < 8; ++i)
+			{
+				threads.emplace_back([&]
+				{
+					if (resolver.Resolve("host").size() == 2)
+						++resolved;
+				});
+			}
+			std::this_thread::sleep_for(milliseconds(50));
+			lookup.Open();
+			for (auto& thread : threads)
+				thread.join();
+			Assert::Equals(resolved.load(), 8);
+			Assert::Equals(lookup.Count.load(), 2);
+		});
+	}
+};
+_L_Test_Register(ResolverTest);
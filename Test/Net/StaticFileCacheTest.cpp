@@ -0,0 +1,198 @@
+// File: StaticFileCacheTest.cpp
+// Author: Rendong Liang (Liong)
+#include "../../Include/Net/StaticFileCache.hpp"
+#include "../../Include/Testing/Assert.hpp"
+
+#ifdef _L_LINUX
+using namespace LiongPlus::Net;
+using namespace LiongPlus::Testing;
+
+namespace
+{
+	// A root holding "index.html" and "sub/page.html", with links that lead outside it.
+	struct Fixture
+	{
+		std::string Root, Outside;
+
+		Fixture()
+		{
+			char root[] = "/tmp/StaticFileCacheTest.XXXXXX";
+			char outside[] = "/tmp/StaticFileCacheTest.XXXXXX";
+			Root = mkdtemp(root);
+			Outside = mkdtemp(outside);
+			Write(Root + "/index.html", "<html></html>");
+			mkdir((Root + "/sub").c_str(), 0755);
+			Write(Root + "/sub/page.html", "<p></p>");
+			Write(Outside + "/secret.txt", "secret");
+			symlink((Outside + "/secret.txt").c_str(), (Root + "/secret.txt").c_str());
+			symlink(Outside.c_str(), (Root + "/escape").c_str());
+		}
+		~Fixture()
+		{
+			unlink((Root + "/escape").c_str());
+			unlink((Root + "/secret.txt").c_str());
+			unlink((Root + "/sub/page.html").c_str());
+			rmdir((Root + "/sub").c_str());
+			unlink((Root + "/index.html").c_str());
+			rmdir(Root.c_str());
+			unlink((Outside + "/secret.txt").c_str());
+			rmdir(Outside.c_str());
+		}
+
+		static void Write(const std::string& path, const char* content)
+		{
+			int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+			write(fd, content, strlen(content));
+			close(fd);
+		}
+	};
+
+	// A connected pair of blocking loopback sockets, the first one accepted.
+	std::pair<Socket, Socket> ConnectPair()
+	{
+		IPv4EndPoint addr("127.0.0.1", 0);
+		Socket listener(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		listener.Bind(addr);
+		socklen_t length = sizeof(sockaddr_in);
+		getsockname(listener.Handle(), (sockaddr*)addr.Field(), &length);
+		listener.Listen(1);
+		Socket client(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		client.Connect(addr);
+		SocketAddress peer(SocketAddress::MAX_LENGTH);
+		auto server = listener.Accept(peer);
+		return std::make_pair(std::move(server), std::move(client));
+	}
+
+	std::string ReceiveExactly(Socket& socket, size_t length)
+	{
+		std::string received(length, '\0');
+		for (size_t offset = 0; offset < length;)
+		{
+			auto rv = socket.TryReceive(&received[offset], length - offset, 0);
+			if (rv <= 0)
+				throw std::runtime_error("Failed in receiving the response.");
+			offset += rv;
+		}
+		return received;
+	}
+
+	std::string ToString(const SharedBuffer& buffer)
+	{
+		return std::string(buffer.Field(), buffer.Length());
+	}
+}
+
+_L_Test_Class(StaticFileCacheTest)
+{
+	_L_Test_TestList
+	{
+		_L_Test_Unit("Get", []
+		{
+			Fixture fixture;
+			StaticFileCache cache(fixture.Root);
+			auto entry = cache.Get("index.html");
+			Assert::Equals(entry != nullptr, true);
+			Assert::Equals<size_t>(entry->Length, 13);
+			Assert::Equals(cache.Get("index.html") == entry, true);
+			Assert::Equals(cache.Get("sub/page.html") != nullptr, true);
+			Assert::Equals(cache.Get("sub") == nullptr, true);
+			Assert::Equals(cache.Get("missing.html") == nullptr, true);
+			Assert::Equals<size_t>(cache.Count(), 2);
+		});
+		_L_Test_Unit("StayBeneathRoot", []
+		{
+			Fixture fixture;
+			StaticFileCache cache(fixture.Root);
+			Assert::Equals(cache.Get("../" + fixture.Outside.substr(5) + "/secret.txt") == nullptr, true);
+			Assert::Equals(cache.Get(fixture.Outside + "/secret.txt") == nullptr, true);
+			Assert::Equals(cache.Get("secret.txt") == nullptr, true);
+			Assert::Equals(cache.Get("escape/secret.txt") == nullptr, true);
+			Assert::Equals<size_t>(cache.Count(), 0);
+		});
+		_L_Test_Unit("Send", []
+		{
+			Fixture fixture;
+			StaticFileCache cache(fixture.Root);
+			auto entry = cache.Get("index.html");
+			auto sockets = ConnectPair();
+			StaticFileCache::Send(sockets.first, *entry, false);
+			auto response = ReceiveExactly(sockets.second, entry->Head.Length() + entry->Length);
+			Assert::Equals(response.compare(0, 15, "HTTP/1.1 200 OK"), 0);
+			Assert::Equals(response.find(entry->ETag) != std::string::npos, true);
+			Assert::Equals(response.substr(entry->Head.Length()), std::string("<html></html>"));
+		});
+		_L_Test_Unit("SendNotModified", []
+		{
+			Fixture fixture;
+			StaticFileCache cache(fixture.Root);
+			auto entry = cache.Get("index.html");
+			Assert::Equals(StaticFileCache::IsNotModified(*entry, entry->ETag), true);
+			Assert::Equals(StaticFileCache::IsNotModified(*entry, "\"other\", W/" + entry->ETag), true);
+			Assert::Equals(StaticFileCache::IsNotModified(*entry, "*"), true);
+			Assert::Equals(StaticFileCache::IsNotModified(*entry, "\"other\""), false);
+			Assert::Equals(StaticFileCache::IsNotModified(*entry, ""), false);
+
+			auto sockets = ConnectPair();
+			StaticFileCache::Send(sockets.first, *entry, true);
+			auto response = ReceiveExactly(sockets.second, entry->NotModifiedHead.Length());
+			Assert::Equals(response, ToString(entry->NotModifiedHead));
+			Assert::Equals(response.compare(0, 25, "HTTP/1.1 304 Not Modified"), 0);
+			// No body follows.
+			sockets.first.Close();
+			Byte trash;
+			Assert::Equals(sockets.second.TryReceive(&trash, 1, 0), 0L);
+		});
+		_L_Test_Unit("EvictByCount", []
+		{
+			Fixture fixture;
+			StaticFileCache cache(fixture.Root, 1024 * 1024, 1);
+			auto index = cache.Get("index.html");
+			cache.Get("sub/page.html");
+			Assert::Equals<size_t>(cache.Count(), 1);
+			// Evicted entries stay usable while held, but the next lookup builds a new one.
+			Assert::Equals(index->Length, (size_t)13);
+			Assert::Equals(cache.Get("index.html") != index, true);
+			Assert::Equals<size_t>(cache.Count(), 1);
+		});
+		_L_Test_Unit("EvictBySize", []
+		{
+			Fixture fixture;
+			size_t charge;
+			{
+				StaticFileCache probe(fixture.Root);
+				probe.Get("index.html");
+				charge = probe.Size();
+			}
+			// Room for one entry but not two.
+			StaticFileCache cache(fixture.Root, charge + charge / 2);
+			auto index = cache.Get("index.html");
+			auto page = cache.Get("sub/page.html");
+			Assert::Equals<size_t>(cache.Count(), 1);
+			Assert::Equals(cache.Size() <= charge + charge / 2, true);
+			// The least recently used one went.
+			Assert::Equals(cache.Get("sub/page.html") == page, true);
+			Assert::Equals(cache.Get("index.html") != index, true);
+		});
+		_L_Test_Unit("RevalidateAfterChange", []
+		{
+			Fixture fixture;
+			StaticFileCache cache(fixture.Root, 1024 * 1024, 1024, std::chrono::seconds(0));
+			auto before = cache.Get("index.html");
+			Assert::Equals(cache.Get("index.html") == before, true);
+			// Same size, within the same second most of the time; only the sub-second time or the inode tells.
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			Fixture::Write(fixture.Root + "/index.html", "<HTML></HTML>");
+			auto after = cache.Get("index.html");
+			Assert::Equals(after != before, true);
+			Assert::Equals(after->ETag != before->ETag, true);
+			Assert::Equals(StaticFileCache::IsNotModified(*after, before->ETag), false);
+
+			auto sockets = ConnectPair();
+			StaticFileCache::Send(sockets.first, *after, false);
+			auto response = ReceiveExactly(sockets.second, after->Head.Length() + after->Length);
+			Assert::Equals(response.substr(after->Head.Length()), std::string("<HTML></HTML>"));
+		});
+	}
+};
+_L_Test_Register(StaticFileCacheTest);
+#endif // _L_LINUX
@@ -0,0 +1,60 @@
+// File: CoalescingProgressTest.cpp
+// Author: Rendong Liang (Liong)
+#include "../../Include/Reactive/CoalescingProgress.hpp"
+#include "../../Include/Testing/Assert.hpp"
+
+using namespace std::chrono;
+using namespace LiongPlus::Reactive;
+using namespace LiongPlus::Testing;
+
+_L_Test_Class(CoalescingProgressTest)
+{
+	_L_Test_TestList
+	{
+		_L_Test_Unit("PublishFinalOnDestruction", []
+		{
+			TimerQueue timers;
+			std::vector<int> published;
+			{
+				CoalescingProgress<int> progress([&](int value) { published.push_back(value); }, hours(1), 1, 0, timers);
+				progress.Report(1);
+				progress.Report(2);
+			}
+			Assert::Equals<size_t>(published.size(), 1);
+			Assert::Equals(published.back(), 2);
+		});
+		_L_Test_Unit("DestroyWhileFlushing", []
+		{
+			// The timer is cancelled while its flush is still publishing, which must neither crash nor flush again afterwards.
+			TimerQueue timers;
+			for (int i = 0; i < 10; ++i)
+			{
+				std::mutex mutex;
+				std::condition_variable cond;
+				bool isFlushing = false;
+				std::atomic<int> count(0);
+				{
+					CoalescingProgress<int> progress([&](int)
+					{
+						{
+							std::lock_guard<std::mutex> lock(mutex);
+							isFlushing = true;
+						}
+						cond.notify_all();
+						std::this_thread::sleep_for(milliseconds(10));
+						++count;
+					}, milliseconds(1), 1, 0, timers);
+					progress.Report(1);
+					std::unique_lock<std::mutex> lock(mutex);
+					cond.wait(lock, [&] { return isFlushing; });
+					progress.Report(2);
+				}
+				auto final = count.load();
+				std::this_thread::sleep_for(milliseconds(5));
+				Assert::Equals(final, 2);
+				Assert::Equals(count.load(), final);
+			}
+		});
+	}
+};
+_L_Test_Register(CoalescingProgressTest);
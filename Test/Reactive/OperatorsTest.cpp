@@ -0,0 +1,178 @@
+// File: OperatorsTest.cpp
+// Author: Rendong Liang (Liong)
+#include "../../Include/Reactive/Operators.hpp"
+#include "../../Include/Testing/Assert.hpp"
+
+using namespace std::chrono;
+using namespace LiongPlus;
+using namespace LiongPlus::Reactive;
+using namespace LiongPlus::Testing;
+
+namespace
+{
+	const int VALUES[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+	// Records what reaches it, telling batches from single values. While gated, deliveries wait until it is opened.
+	template<typename T>
+	class Recorder
+		: public IObserver<T>
+	{
+	private:
+		std::mutex _Mutex;
+		std::condition_variable _Cond;
+		bool _IsGated;
+
+		void Record(const T* values, size_t count, bool isBatch)
+		{
+			std::unique_lock<std::mutex> lock(_Mutex);
+			_Cond.wait(lock, [this] { return !_IsGated; });
+			Values.insert(Values.end(), values, values + count);
+			if (isBatch)
+				BatchSizes.push_back(count);
+			else
+				++SingleCount;
+		}
+	public:
+		std::vector<T> Values;
+		std::vector<size_t> BatchSizes;
+		size_t SingleCount;
+		size_t ValueCountOnCompleted;
+		bool IsCompleted;
+
+		Recorder(bool isGated = false)
+			: _Mutex()
+			, _Cond()
+			, _IsGated(isGated)
+			, Values()
+			, BatchSizes()
+			, SingleCount(0)
+			, ValueCountOnCompleted(0)
+			, IsCompleted(false)
+		{
+		}
+
+		void OnCompleted() override
+		{
+			{
+				std::lock_guard<std::mutex> lock(_Mutex);
+				IsCompleted = true;
+				ValueCountOnCompleted = Values.size();
+			}
+			_Cond.notify_all();
+		}
+		void OnError(std::exception_ptr) override
+		{
+		}
+		void OnNext(const T& value) override
+		{
+			Record(&value, 1, false);
+		}
+		void OnNextBatch(const T* values, size_t count) override
+		{
+			Record(values, count, true);
+		}
+
+		void Open()
+		{
+			{
+				std::lock_guard<std::mutex> lock(_Mutex);
+				_IsGated = false;
+			}
+			_Cond.notify_all();
+		}
+		bool WaitForCompletion()
+		{
+			std::unique_lock<std::mutex> lock(_Mutex);
+			return _Cond.wait_for(lock, seconds(5), [this] { return IsCompleted; });
+		}
+		size_t ValueCount()
+		{
+			std::lock_guard<std::mutex> lock(_Mutex);
+			return Values.size();
+		}
+	};
+}
+
+_L_Test_Class(OperatorsTest)
+{
+	_L_Test_TestList
+	{
+		_L_Test_Unit("MapFilterKeepBatches", []
+		{
+			auto source = std::make_shared<Subject<int>>();
+			auto recorder = std::make_shared<Recorder<int>>();
+			auto doubled = Map(source, [](int value) { return value * 2; });
+			auto subscription = Filter(doubled, [](int value) { return value % 4 == 0; })->Subscribe(recorder);
+			source->OnNextBatch(VALUES, 8);
+			Assert::Equals(recorder->Values == std::vector<int>({ 4, 8, 12, 16 }), true);
+			Assert::Equals(recorder->BatchSizes == std::vector<size_t>({ 4 }), true);
+			Assert::Equals<size_t>(recorder->SingleCount, 0);
+		});
+		_L_Test_Unit("BufferFlushOnCompletion", []
+		{
+			auto source = std::make_shared<Subject<int>>();
+			auto recorder = std::make_shared<Recorder<std::vector<int>>>();
+			auto subscription = Buffer(source, 3)->Subscribe(recorder);
+			source->OnNextBatch(VALUES, 7);
+			Assert::Equals<size_t>(recorder->Values.size(), 2);
+			source->OnCompleted();
+			Assert::Equals<size_t>(recorder->Values.size(), 3);
+			Assert::Equals(recorder->Values[1] == std::vector<int>({ 4, 5, 6 }), true);
+			Assert::Equals(recorder->Values[2] == std::vector<int>({ 7 }), true);
+			Assert::Equals(recorder->IsCompleted, true);
+		});
+		_L_Test_Unit("QueueBackPressure", []
+		{
+			auto source = std::make_shared<Subject<int>>();
+			auto recorder = std::make_shared<Recorder<int>>(true);
+			auto subscription = Queue(source, 4)->Subscribe(recorder);
+			std::atomic<int> produced(0);
+			std::thread producer([&]
+			{
+				for (int i = 0; i < 100; ++i)
+				{
+					source->OnNext(i);
+					++produced;
+				}
+				source->OnCompleted();
+			});
+			std::this_thread::sleep_for(milliseconds(50));
+			// The consumer holds one batch and the queue behind it is full, so the producer is blocked.
+			Assert::Equals(produced.load() <= 8, true);
+			recorder->Open();
+			producer.join();
+			Assert::Equals(recorder->WaitForCompletion(), true);
+			std::vector<int> expected;
+			for (int i = 0; i < 100; ++i)
+				expected.push_back(i);
+			Assert::Equals(recorder->Values == expected, true);
+			Assert::Equals<size_t>(recorder->ValueCountOnCompleted, 100);
+		});
+		_L_Test_Unit("DisposeQueueFromAnotherThread", []
+		{
+			auto source = std::make_shared<Subject<int>>();
+			auto recorder = std::make_shared<Recorder<int>>(true);
+			auto subscription = Queue(source, 4)->Subscribe(recorder);
+			std::thread producer([&]
+			{
+				for (int i = 0; i < 100; ++i)
+					source->OnNext(i);
+			});
+			std::this_thread::sleep_for(milliseconds(20));
+			// Disposing waits for the consumer, which is only let go afterwards; the blocked producer must be released as well.
+			std::thread disposer([&] { subscription.Dispose(); });
+			std::this_thread::sleep_for(milliseconds(20));
+			recorder->Open();
+			disposer.join();
+			producer.join();
+			Assert::Equals(source->HasObservers(), false);
+			auto count = recorder->ValueCount();
+			Assert::Equals(count < 100, true);
+			source->OnNext(100);
+			std::this_thread::sleep_for(milliseconds(10));
+			Assert::Equals(recorder->ValueCount(), count);
+			Assert::Equals(recorder->IsCompleted, false);
+		});
+	}
+};
+_L_Test_Register(OperatorsTest);